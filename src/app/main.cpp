@@ -15,7 +15,7 @@
 
 using ProjectionWrapper = TrackMapper::Raster::ProjectionWrapper;
 using TrackScene = TrackMapper::Scene::TrackScene;
-using PointGrid = TrackMapper::Raster::PointGrid;
+using Heightfield = TrackMapper::Raster::Heightfield;
 using OSMPoint = TrackMapper::Raster::OSMPoint;
 using Point3D = TrackMapper::Raster::Point;
 
@@ -27,7 +27,7 @@ struct Config {
     bool originIsSet = false;
     bool markersAreSet = false;
 
-    std::vector<PointGrid> rasters;
+    std::vector<Heightfield> rasters;
 };
 
 void addTerrain(Config &config);
@@ -75,10 +75,10 @@ void addTerrain(Config &config) {
 
     std::cout << "Task 1/4: Opening geo dataset" << std::endl;
     TrackMapper::Raster::GDALDatasetWrapper dataset(inFilePath);
-    const auto pointGrid = TrackMapper::Raster::readRasterData(dataset);
+    auto heightfield = TrackMapper::Raster::readRasterData(dataset);
 
     std::cout << "Task 2/4: Creating mesh" << std::endl;
-    auto mesh = TrackMapper::Mesh::meshFromRasterData(pointGrid);
+    auto mesh = TrackMapper::Mesh::meshFromRasterData(heightfield);
 
     std::cout << "Task 3/4: Simplifying mesh" << std::endl;
     const double reductionRation = std::min(40e3 / mesh.number_of_vertices(), 0.5);
@@ -86,16 +86,16 @@ void addTerrain(Config &config) {
 
     std::cout << "Task 4/4: Adding mesh to scene" << std::endl;
     if (!config.originIsSet) {
-        config.origin = pointGrid.origin;
-        config.projRef = pointGrid.projRef;
+        config.origin = heightfield.origin;
+        config.projRef = heightfield.projRef;
         config.originIsSet = true;
     }
 
-    const auto [x, y, z] = pointGrid.origin - config.origin;
+    const auto [x, y, z] = heightfield.origin - config.origin;
     auto sceneMesh = TrackMapper::Mesh::cgalToSceneMesh(mesh, {x, y, z});
 
     config.scene.AddGrassMesh(sceneMesh);
-    config.rasters.push_back(pointGrid);
+    config.rasters.push_back(std::move(heightfield));
     std::cout << "Finished: Added terrain with " << sceneMesh.vertices.size() << " vertices to scene" << std::endl;
 }
 
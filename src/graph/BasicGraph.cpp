@@ -6,9 +6,9 @@
 
 BasicGraph::BasicGraph(const int nodeCount,
                        const int edgeCount,
-                       std::unique_ptr<Location[]> nodeLocations,
-                       std::unique_ptr<int[]> edgesLookupIndices,
-                       std::unique_ptr<Edge[]> edges)
+                       HugePageArray<Location> nodeLocations,
+                       HugePageArray<int> edgesLookupIndices,
+                       HugePageArray<Edge> edges)
     : m_NodeCount(nodeCount),
       m_EdgeCount(edgeCount),
       m_pNodeLocations(std::move(nodeLocations)),
@@ -20,6 +20,14 @@ int BasicGraph::GetNodeCount() const {
     return m_NodeCount;
 }
 
+int BasicGraph::GetEdgeCount() const {
+    return m_EdgeCount;
+}
+
+size_t BasicGraph::GetMemoryUsage() const {
+    return m_NodeCount * sizeof(Location) + (m_NodeCount + 1) * sizeof(int) + m_EdgeCount * sizeof(Edge);
+}
+
 std::vector<Edge> BasicGraph::GetEdges(const int nodeIndex) const {
     const int startIndex = m_pEdgesLookupIndices[nodeIndex];
     const int nextNodeStartIndex = m_pEdgesLookupIndices[nodeIndex+1];
@@ -4,18 +4,22 @@
 
 #ifndef SIMPLEGRAPH_H
 #define SIMPLEGRAPH_H
-#include <memory>
-
+#include "HugePageArray.h"
 #include "IGraph.h"
 
 
 class BasicGraph final : public IGraph {
 public:
-    BasicGraph(int nodeCount, int edgeCount, std::unique_ptr<Location[]> nodeLocations,
-               std::unique_ptr<int[]> edgesLookupIndices, std::unique_ptr<Edge[]> edges);
+    BasicGraph(int nodeCount, int edgeCount, HugePageArray<Location> nodeLocations,
+               HugePageArray<int> edgesLookupIndices, HugePageArray<Edge> edges);
 
     [[nodiscard]] int GetNodeCount() const override;
 
+    [[nodiscard]] int GetEdgeCount() const;
+
+    /// @return bytes used by the node and edge arrays
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
     [[nodiscard]] std::vector<Edge> GetEdges(int nodeIndex) const override;
 
     [[nodiscard]] Location GetLocation(int nodeIndex) const override;
@@ -23,9 +27,9 @@ public:
 private:
     int m_NodeCount;
     int m_EdgeCount;
-    std::unique_ptr<Location[]> m_pNodeLocations;
-    std::unique_ptr<int[]> m_pEdgesLookupIndices;
-    std::unique_ptr<Edge[]> m_pEdges;
+    HugePageArray<Location> m_pNodeLocations;
+    HugePageArray<int> m_pEdgesLookupIndices;
+    HugePageArray<Edge> m_pEdges;
 };
 
 
@@ -13,6 +13,22 @@ DijkstraPathfinding::DijkstraPathfinding(const IGraph &graph) : graph(graph) {
 }
 
 Path DijkstraPathfinding::CalculatePath(const int startNodeIndex, const int targetNodeIndex) const {
+    NoSearchStats statsPolicy;
+    return CalculatePathWithPolicy(startNodeIndex, targetNodeIndex, statsPolicy);
+}
+
+Path DijkstraPathfinding::CalculatePath(const int startNodeIndex, const int targetNodeIndex,
+                                        SearchStats &stats) const {
+    SearchStatsRecorder statsPolicy(stats);
+    return CalculatePathWithPolicy(startNodeIndex, targetNodeIndex, statsPolicy);
+}
+
+template<typename TStatsPolicy>
+Path DijkstraPathfinding::CalculatePathWithPolicy(const int startNodeIndex, const int targetNodeIndex,
+                                                  TStatsPolicy &statsPolicy) const {
+    statsPolicy.StartQuery();
+    statsPolicy.StartReset();
+
     auto predecessors = std::make_unique<int[]>(graph.GetNodeCount());
     auto distances = std::make_unique<int[]>(graph.GetNodeCount());
 
@@ -21,19 +37,24 @@ Path DijkstraPathfinding::CalculatePath(const int startNodeIndex, const int targ
 
     std::priority_queue<PriorityQueueEntry, std::vector<PriorityQueueEntry>, std::greater<> > queue;
 
+    statsPolicy.EndReset();
+
     distances[startNodeIndex] = 0;
     queue.emplace(startNodeIndex, 0);
+    statsPolicy.OnHeapPush();
 
     // -- dijkstra algorithm --
 
     while (!queue.empty()) {
         auto [curNodeIndex, curDistance] = queue.top();
         queue.pop();
+        statsPolicy.OnHeapPop();
 
         if (distances[curNodeIndex] < curDistance) {
             // popped node is an outdated entry with old distance value
             continue;
         }
+        statsPolicy.OnSettle();
 
         if (curNodeIndex == targetNodeIndex) {
             // reached target node
@@ -41,6 +62,7 @@ Path DijkstraPathfinding::CalculatePath(const int startNodeIndex, const int targ
         }
 
         for (auto [edgeTarget, edgeDistance]: graph.GetEdges(curNodeIndex)) {
+            statsPolicy.OnRelax();
             int newDistance = curDistance + edgeDistance;
             if (distances[edgeTarget] <= newDistance) {
                 // edge is already reachable with shorter path
@@ -50,6 +72,7 @@ Path DijkstraPathfinding::CalculatePath(const int startNodeIndex, const int targ
             distances[edgeTarget] = newDistance;
             predecessors[edgeTarget] = curNodeIndex;
             queue.emplace(edgeTarget, newDistance);
+            statsPolicy.OnHeapPush();
         }
     }
 
@@ -57,6 +80,7 @@ Path DijkstraPathfinding::CalculatePath(const int startNodeIndex, const int targ
 
     if (predecessors[targetNodeIndex] == -1) {
         // no path was found
+        statsPolicy.EndQuery();
         return Path::invalid();
     }
 
@@ -70,5 +94,6 @@ Path DijkstraPathfinding::CalculatePath(const int startNodeIndex, const int targ
 
     std::ranges::reverse(path);
 
+    statsPolicy.EndQuery();
     return {path, distances[targetNodeIndex]};
 }
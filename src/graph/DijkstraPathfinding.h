@@ -6,6 +6,7 @@
 #define DIJKSTRAPATHFINDING_H
 
 #include "IGraph.h"
+#include "SearchStats.h"
 
 struct Path {
     std::vector<int> nodeIds;
@@ -35,8 +36,16 @@ public:
 
     [[nodiscard]] Path CalculatePath(int startNodeIndex, int targetNodeIndex) const;
 
+    /// @param stats counters of this query get added to it
+    [[nodiscard]] Path CalculatePath(int startNodeIndex, int targetNodeIndex, SearchStats &stats) const;
+
 private:
     const IGraph &graph;
+
+    /// @tparam TStatsPolicy NoSearchStats or SearchStatsRecorder, decides at compile time what gets recorded
+    template<typename TStatsPolicy>
+    [[nodiscard]] Path CalculatePathWithPolicy(int startNodeIndex, int targetNodeIndex,
+                                               TStatsPolicy &statsPolicy) const;
 };
 
 
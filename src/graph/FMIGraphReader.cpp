@@ -38,9 +38,9 @@ BasicGraph FMIGraphReader::read(const std::string &filePath) {
     std::getline(fileReadStream, line); // get remaining new line symbol
     // TODO: check int limits
 
-    std::unique_ptr<Location[]> nodeLocations(new Location[nodeCount]);
-    std::unique_ptr<int[]> edgesLookupIndices(new int[nodeCount + 1]); // +1 dummy entry for simplified algorithm
-    std::unique_ptr<Edge[]> edges(new Edge[edgeCount]);
+    auto nodeLocations = MakeHugePageArray<Location>(nodeCount);
+    auto edgesLookupIndices = MakeHugePageArray<int>(nodeCount + 1); // +1 dummy entry for simplified algorithm
+    auto edges = MakeHugePageArray<Edge>(edgeCount);
 
     std::cout << "Loading graph with " << nodeCount << " nodes and " << edgeCount << " edges.." << std::endl;
     auto startTime = std::chrono::high_resolution_clock::now();
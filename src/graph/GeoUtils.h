@@ -0,0 +1,34 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef GEOUTILS_H
+#define GEOUTILS_H
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "IGraph.h"
+
+inline constexpr double EARTH_RADIUS_METERS = 6371008.8; // mean earth radius
+
+inline double degreesToRadians(const double degrees) { return degrees * std::numbers::pi / 180.; }
+
+/**
+ * Calculates the great circle distance between two locations using the haversine formula
+ * @note Assumes a spherical earth, the error compared to the ellipsoid is below 0.5%
+ * @return distance in meters
+ */
+inline double haversineDistance(const Location &a, const Location &b) {
+    const double dLat = degreesToRadians(b.latitude - a.latitude);
+    const double dLon = degreesToRadians(b.longitude - a.longitude);
+    const double sinLat = std::sin(dLat * .5);
+    const double sinLon = std::sin(dLon * .5);
+
+    const double h = sinLat * sinLat +
+                     std::cos(degreesToRadians(a.latitude)) * std::cos(degreesToRadians(b.latitude)) * sinLon * sinLon;
+    return 2 * EARTH_RADIUS_METERS * std::asin(std::sqrt(std::min(h, 1.)));
+}
+
+#endif //GEOUTILS_H
@@ -0,0 +1,16 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "GraphReader.h"
+
+#include "FMIGraphReader.h"
+#include "OSMPBFGraphReader.h"
+
+BasicGraph GraphReader::read(const std::string &filePath) {
+    if (filePath.ends_with(".pbf")) {
+        return OSMPBFGraphReader::read(filePath);
+    }
+
+    return FMIGraphReader::read(filePath);
+}
@@ -0,0 +1,18 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef GRAPHREADER_H
+#define GRAPHREADER_H
+#include <string>
+
+#include "BasicGraph.h"
+
+class GraphReader {
+public:
+    /// Reads a graph from either a .fmi file or an .osm.pbf file based on the file extension
+    static BasicGraph read(const std::string &filePath);
+};
+
+
+#endif //GRAPHREADER_H
@@ -0,0 +1,128 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "HugePageArray.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__) || defined(_WIN64)
+#define HUGEPAGES_WINDOWS
+#include <windows.h>
+#elif __linux__
+#define HUGEPAGES_LINUX
+#include <sys/mman.h>
+#endif
+
+static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024; // 2 MB
+static constexpr std::size_t DEFAULT_ALIGNMENT = 64; // cache line
+
+static std::atomic<bool> s_HugePagesEnabled = true;
+static std::atomic<std::size_t> s_HugePageBytes = 0;
+
+static std::size_t roundUp(const std::size_t value, const std::size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+#ifdef HUGEPAGES_LINUX
+static void *mapExplicitHugePages(const std::size_t byteSize) {
+    // only succeeds if huge pages got reserved by the system administrator (vm.nr_hugepages)
+    void *pMemory = mmap(nullptr, byteSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    return pMemory == MAP_FAILED ? nullptr : pMemory;
+}
+
+static void *mapTransparentHugePages(const std::size_t byteSize) {
+    // over allocate to be able to align the mapping to the huge page size, otherwise the first and last partial huge
+    // page could not be promoted
+    const std::size_t mappedSize = byteSize + HUGE_PAGE_SIZE;
+    void *pMapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pMapped == MAP_FAILED)
+        return nullptr;
+
+    const auto mappedStart = reinterpret_cast<std::uintptr_t>(pMapped);
+    const auto alignedStart = roundUp(mappedStart, HUGE_PAGE_SIZE);
+    const std::size_t headSize = alignedStart - mappedStart;
+    const std::size_t tailSize = mappedSize - headSize - byteSize;
+
+    // unmap the unaligned parts in front of and behind the aligned range
+    if (headSize > 0)
+        munmap(pMapped, headSize);
+    if (tailSize > 0)
+        munmap(reinterpret_cast<void *>(alignedStart + byteSize), tailSize);
+
+    auto pMemory = reinterpret_cast<void *>(alignedStart);
+    // only a hint: if THP is disabled the memory just stays backed by regular pages
+    madvise(pMemory, byteSize, MADV_HUGEPAGE);
+    return pMemory;
+}
+#endif
+
+#ifdef HUGEPAGES_WINDOWS
+static void *allocateLargePages(const std::size_t byteSize) {
+    // only succeeds if the process holds the SeLockMemoryPrivilege
+    return VirtualAlloc(nullptr, byteSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+}
+#endif
+
+HugePageDeleter AllocateHugePageMemory(const std::size_t byteSize, void **ppMemory) {
+    if (s_HugePagesEnabled && byteSize >= HUGE_PAGE_SIZE) {
+#ifdef HUGEPAGES_LINUX
+        // memory of anonymous mappings is always zero initialized
+        const std::size_t hugeSize = roundUp(byteSize, HUGE_PAGE_SIZE);
+        if (void *pMemory = mapExplicitHugePages(hugeSize)) {
+            s_HugePageBytes += hugeSize;
+            *ppMemory = pMemory;
+            return {hugeSize, PageBacking::Explicit};
+        }
+        if (void *pMemory = mapTransparentHugePages(hugeSize)) {
+            s_HugePageBytes += hugeSize;
+            *ppMemory = pMemory;
+            return {hugeSize, PageBacking::Transparent};
+        }
+#elif defined(HUGEPAGES_WINDOWS)
+        // memory of VirtualAlloc is always zero initialized
+        if (const std::size_t largePageSize = GetLargePageMinimum(); largePageSize > 0) {
+            const std::size_t largeSize = roundUp(byteSize, largePageSize);
+            if (void *pMemory = allocateLargePages(largeSize)) {
+                s_HugePageBytes += largeSize;
+                *ppMemory = pMemory;
+                return {largeSize, PageBacking::Explicit};
+            }
+        }
+#endif
+    }
+
+    // fallback: regular heap allocation
+    const std::size_t size = byteSize > 0 ? byteSize : 1;
+    void *pMemory = ::operator new(size, std::align_val_t{DEFAULT_ALIGNMENT});
+    std::memset(pMemory, 0, size);
+    *ppMemory = pMemory;
+    return {size, PageBacking::Default};
+}
+
+void HugePageDeleter::operator()(void *pMemory) const {
+    if (pMemory == nullptr)
+        return;
+
+    switch (backing) {
+        case PageBacking::Default:
+            ::operator delete(pMemory, std::align_val_t{DEFAULT_ALIGNMENT});
+            return;
+        case PageBacking::Transparent:
+        case PageBacking::Explicit:
+            s_HugePageBytes -= byteSize;
+#ifdef HUGEPAGES_LINUX
+            munmap(pMemory, byteSize);
+#elif defined(HUGEPAGES_WINDOWS)
+            VirtualFree(pMemory, 0, MEM_RELEASE);
+#endif
+            return;
+    }
+}
+
+void SetHugePagesEnabled(const bool enabled) { s_HugePagesEnabled = enabled; }
+
+std::size_t GetHugePageBytes() { return s_HugePageBytes; }
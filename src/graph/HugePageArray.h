@@ -0,0 +1,53 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef HUGEPAGEARRAY_H
+#define HUGEPAGEARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+enum class PageBacking {
+    Default, // regular heap allocation
+    Transparent, // anonymous mapping advised to be backed by transparent huge pages
+    Explicit, // mapping backed by explicitly reserved huge/large pages
+};
+
+struct HugePageDeleter {
+    std::size_t byteSize = 0;
+    PageBacking backing = PageBacking::Default;
+
+    void operator()(void *pMemory) const;
+};
+
+/// Array for large, long living data (e.g. graph arrays) whose memory is backed by huge pages where available to
+/// reduce TLB misses on random access
+template<typename T>
+using HugePageArray = std::unique_ptr<T[], HugePageDeleter>;
+
+/**
+ * Allocates zero initialized memory, trying explicit huge pages first, then transparent huge pages and falling back to
+ * a regular allocation
+ * @note Allocations smaller than a huge page are always regular allocations
+ */
+HugePageDeleter AllocateHugePageMemory(std::size_t byteSize, void **ppMemory);
+
+/// Globally enables or disables huge page backing for following allocations (enabled by default)
+void SetHugePagesEnabled(bool enabled);
+
+/// @return amount of currently allocated bytes that are backed by huge pages
+[[nodiscard]] std::size_t GetHugePageBytes();
+
+template<typename T>
+HugePageArray<T> MakeHugePageArray(const std::size_t count) {
+    // memory is only zero filled, so no constructors or destructors get called
+    static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>);
+
+    void *pMemory = nullptr;
+    const HugePageDeleter deleter = AllocateHugePageMemory(count * sizeof(T), &pMemory);
+    return HugePageArray<T>(static_cast<T *>(pMemory), deleter);
+}
+
+#endif //HUGEPAGEARRAY_H
@@ -0,0 +1,628 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "OSMPBFGraphReader.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "GeoUtils.h"
+
+// File format: https://wiki.openstreetmap.org/wiki/PBF_Format
+// Message definitions: https://github.com/openstreetmap/OSM-binary/blob/master/osmpbf/fileformat.proto and
+// https://github.com/openstreetmap/OSM-binary/blob/master/osmpbf/osmformat.proto
+
+namespace {
+    /// Minimal reader for the protobuf wire format, only supports what is needed for osm pbf files
+    struct ProtoReader {
+        enum WireType { VARINT = 0, FIXED64 = 1, LENGTH_DELIMITED = 2, FIXED32 = 5 };
+
+        const uint8_t *pos;
+        const uint8_t *end;
+
+        int field = 0;
+        int wireType = 0;
+
+        explicit ProtoReader(const std::string_view data) :
+            pos(reinterpret_cast<const uint8_t *>(data.data())), end(pos + data.size()) {}
+
+        /// Reads the next field key, returns false when the end of the message is reached
+        bool Next() {
+            if (pos >= end)
+                return false;
+
+            const uint64_t key = ReadVarint();
+            field = static_cast<int>(key >> 3);
+            wireType = static_cast<int>(key & 0x7);
+            return true;
+        }
+
+        uint64_t ReadVarint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (pos >= end)
+                    throw std::runtime_error("Malformed osm pbf file: truncated varint");
+
+                const uint8_t byte = *pos++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                    return value;
+            }
+            throw std::runtime_error("Malformed osm pbf file: varint too long");
+        }
+
+        int64_t ReadSVarint() {
+            // zig zag decoding
+            const uint64_t value = ReadVarint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        std::string_view ReadBytes() {
+            const uint64_t length = ReadVarint();
+            if (length > static_cast<uint64_t>(end - pos))
+                throw std::runtime_error("Malformed osm pbf file: truncated field");
+
+            const std::string_view bytes(reinterpret_cast<const char *>(pos), length);
+            pos += length;
+            return bytes;
+        }
+
+        void Skip() {
+            switch (wireType) {
+                case VARINT: ReadVarint();
+                    break;
+                case FIXED64: pos += 8;
+                    break;
+                case LENGTH_DELIMITED: ReadBytes();
+                    break;
+                case FIXED32: pos += 4;
+                    break;
+                default: throw std::runtime_error("Malformed osm pbf file: unsupported wire type");
+            }
+        }
+
+        /// Reads a repeated varint field that can either be packed or a single value
+        void ReadRepeatedVarint(std::vector<uint64_t> &values) {
+            if (wireType != LENGTH_DELIMITED) {
+                values.push_back(ReadVarint());
+                return;
+            }
+
+            ProtoReader packed(ReadBytes());
+            while (packed.pos < packed.end) {
+                values.push_back(packed.ReadVarint());
+            }
+        }
+
+        /// Reads a repeated sint64 field that can either be packed or a single value
+        void ReadRepeatedSVarint(std::vector<int64_t> &values) {
+            if (wireType != LENGTH_DELIMITED) {
+                values.push_back(ReadSVarint());
+                return;
+            }
+
+            ProtoReader packed(ReadBytes());
+            while (packed.pos < packed.end) {
+                values.push_back(packed.ReadSVarint());
+            }
+        }
+    };
+
+    struct BlobLocation {
+        std::streamoff offset;
+        int size;
+    };
+
+    enum class WayDirection : uint8_t { BOTH, FORWARD, BACKWARD };
+
+    /// All highway ways of one data block, stored flat to avoid one allocation per way
+    struct WayChunk {
+        std::vector<int64_t> refs; // osm node ids, after resolving the index of the node or -1
+        std::vector<uint32_t> wayEnds; // exclusive end index into refs for each way
+        std::vector<WayDirection> directions;
+        bool hasNodes = false;
+    };
+
+    /// Coordinate conversion parameters of a primitive block
+    struct BlockCoordinates {
+        int64_t granularity = 100;
+        int64_t latOffset = 0;
+        int64_t lonOffset = 0;
+
+        [[nodiscard]] double ToDegrees(const int64_t value, const int64_t offset) const {
+            return 1e-9 * static_cast<double>(offset + granularity * value);
+        }
+    };
+} // namespace
+
+static std::vector<BlobLocation> indexDataBlobs(const std::string &filePath);
+
+static std::string readBlob(std::ifstream &stream, const BlobLocation &location);
+
+static void forEachBlob(const std::string &filePath, const std::vector<BlobLocation> &blobs,
+                        const std::vector<bool> &blobFilter,
+                        const std::function<void(int blobIndex, std::string_view block)> &handler);
+
+static WayChunk parseWays(std::string_view block);
+
+static void parseNodes(std::string_view block, const std::vector<int64_t> &nodeIds, Location *locations,
+                       std::atomic<uint8_t> *found);
+
+static int64_t findNodeIndex(const std::vector<int64_t> &nodeIds, int64_t nodeId);
+
+BasicGraph OSMPBFGraphReader::read(const std::string &filePath) {
+    std::cout << "Loading graph from osm pbf file.." << std::endl;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const std::vector<BlobLocation> blobs = indexDataBlobs(filePath);
+
+    // -- pass 1: highway ways of all blocks, decoded in parallel --
+    std::cout << "Loading ways.." << std::endl;
+    std::vector<WayChunk> chunks(blobs.size());
+    forEachBlob(filePath, blobs, std::vector(blobs.size(), true),
+                [&chunks](const int blobIndex, const std::string_view block) { chunks[blobIndex] = parseWays(block); });
+
+    // collect the ids of all nodes used by highways, those are the nodes of the graph
+    std::vector<int64_t> nodeIds;
+    for (const auto &chunk: chunks) {
+        nodeIds.insert(nodeIds.end(), chunk.refs.begin(), chunk.refs.end());
+    }
+    std::ranges::sort(nodeIds);
+    const auto [uniqueEnd, _] = std::ranges::unique(nodeIds);
+    nodeIds.erase(uniqueEnd, nodeIds.end());
+    nodeIds.shrink_to_fit();
+
+    // -- pass 2: locations of the used nodes, only blocks containing nodes need to be decoded again --
+    std::cout << "Loading nodes.." << std::endl;
+    std::vector<Location> locations(nodeIds.size());
+    const auto found = std::make_unique<std::atomic<uint8_t>[]>(nodeIds.size());
+
+    std::vector<bool> nodeBlobs(blobs.size());
+    for (int i = 0; i < blobs.size(); ++i) {
+        nodeBlobs[i] = chunks[i].hasNodes;
+    }
+    forEachBlob(filePath, blobs, nodeBlobs, [&](int, const std::string_view block) {
+        parseNodes(block, nodeIds, locations.data(), found.get());
+    });
+
+    // -- compact nodes: ways of an extract can reference nodes outside of it which have no location --
+    std::vector<int> compactIndices(nodeIds.size(), -1);
+    int nodeCount = 0;
+    for (int i = 0; i < nodeIds.size(); ++i) {
+        if (found[i]) {
+            if (nodeCount == std::numeric_limits<int>::max())
+                throw std::runtime_error("Graph in file exceeds the supported node count: " + filePath);
+            compactIndices[i] = nodeCount++;
+        }
+    }
+
+    auto nodeLocations = MakeHugePageArray<Location>(nodeCount);
+    for (int i = 0; i < nodeIds.size(); ++i) {
+        if (compactIndices[i] != -1)
+            nodeLocations[compactIndices[i]] = locations[i];
+    }
+    locations = {};
+
+    // -- build edges grouped by source node --
+    std::cout << "Building edges.." << std::endl;
+    // resolve osm node ids to graph node indices in parallel
+    {
+        std::atomic<int> nextChunk = 0;
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < std::max(1u, std::thread::hardware_concurrency()); ++t) {
+            workers.emplace_back([&] {
+                for (int c = nextChunk++; c < chunks.size(); c = nextChunk++) {
+                    for (auto &ref: chunks[c].refs) {
+                        const int64_t index = findNodeIndex(nodeIds, ref);
+                        ref = index == -1 ? -1 : compactIndices[index];
+                    }
+                }
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+    }
+    nodeIds = {};
+    compactIndices = {};
+
+    // calls handler(source, target) for every directed edge of the highways
+    const auto forEachEdge = [&chunks](const auto &handler) {
+        for (const auto &chunk: chunks) {
+            uint32_t wayStart = 0;
+            for (int w = 0; w < chunk.wayEnds.size(); ++w) {
+                const WayDirection direction = chunk.directions[w];
+                for (uint32_t i = wayStart + 1; i < chunk.wayEnds[w]; ++i) {
+                    const auto a = static_cast<int>(chunk.refs[i - 1]);
+                    const auto b = static_cast<int>(chunk.refs[i]);
+                    if (a == -1 || b == -1 || a == b)
+                        continue;
+
+                    if (direction != WayDirection::BACKWARD)
+                        handler(a, b);
+                    if (direction != WayDirection::FORWARD)
+                        handler(b, a);
+                }
+                wayStart = chunk.wayEnds[w];
+            }
+        }
+    };
+
+    auto edgesLookupIndices = MakeHugePageArray<int>(nodeCount + 1); // +1 dummy entry for simplified algorithm
+    int64_t edgeCount = 0;
+    forEachEdge([&](const int source, int) {
+        edgesLookupIndices[source + 1]++;
+        edgeCount++;
+    });
+    if (edgeCount > std::numeric_limits<int>::max())
+        throw std::runtime_error("Graph in file exceeds the supported edge count: " + filePath);
+
+    // prefix sum turns the per node edge counts into start indices
+    for (int i = 0; i < nodeCount; ++i) {
+        edgesLookupIndices[i + 1] += edgesLookupIndices[i];
+    }
+
+    auto edges = MakeHugePageArray<Edge>(edgeCount);
+    std::vector<int> insertIndices(edgesLookupIndices.get(), edgesLookupIndices.get() + nodeCount);
+    forEachEdge([&](const int source, const int target) {
+        const double distance = haversineDistance(nodeLocations[source], nodeLocations[target]);
+        edges[insertIndices[source]++] = {target, static_cast<int>(std::lround(distance))};
+    });
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto loadTimeS = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    std::cout << "Loaded graph with " << nodeCount << " nodes and " << edgeCount << " edges in " << loadTimeS.count()
+              << "s" << std::endl;
+
+    return {nodeCount, static_cast<int>(edgeCount), std::move(nodeLocations), std::move(edgesLookupIndices),
+            std::move(edges)};
+}
+
+/// Reads all blob headers and returns the location of all OSMData blobs in the file
+static std::vector<BlobLocation> indexDataBlobs(const std::string &filePath) {
+    std::ifstream stream(filePath, std::ios::binary);
+    if (!stream.is_open()) {
+        throw std::runtime_error("Could not open file: " + filePath);
+    }
+
+    std::vector<BlobLocation> blobs;
+    std::string header;
+    while (true) {
+        // each blob is preceded by the length of its header as 4 byte big endian integer
+        std::array<uint8_t, 4> lengthBytes{};
+        if (!stream.read(reinterpret_cast<char *>(lengthBytes.data()), lengthBytes.size()))
+            break;
+        const uint32_t headerLength =
+                lengthBytes[0] << 24 | lengthBytes[1] << 16 | lengthBytes[2] << 8 | lengthBytes[3];
+
+        header.resize(headerLength);
+        if (!stream.read(header.data(), headerLength))
+            throw std::runtime_error("Malformed osm pbf file: truncated blob header in " + filePath);
+
+        // BlobHeader: type = 1, datasize = 3
+        std::string_view type;
+        int dataSize = 0;
+        ProtoReader reader(header);
+        while (reader.Next()) {
+            if (reader.field == 1)
+                type = reader.ReadBytes();
+            else if (reader.field == 3)
+                dataSize = static_cast<int>(reader.ReadVarint());
+            else
+                reader.Skip();
+        }
+
+        if (type == "OSMData")
+            blobs.push_back({stream.tellg(), dataSize});
+        // OSMHeader blob only contains metadata and is skipped
+
+        stream.seekg(dataSize, std::ios::cur);
+    }
+
+    return blobs;
+}
+
+/// Reads and decompresses a blob returning the contained block
+static std::string readBlob(std::ifstream &stream, const BlobLocation &location) {
+    std::string blob(location.size, '\0');
+    stream.seekg(location.offset);
+    if (!stream.read(blob.data(), location.size))
+        throw std::runtime_error("Malformed osm pbf file: truncated blob");
+
+    // Blob: raw = 1, raw_size = 2, zlib_data = 3
+    std::string_view raw;
+    std::string_view zlibData;
+    uLongf rawSize = 0;
+    ProtoReader reader(blob);
+    while (reader.Next()) {
+        if (reader.field == 1)
+            raw = reader.ReadBytes();
+        else if (reader.field == 2)
+            rawSize = static_cast<uLongf>(reader.ReadVarint());
+        else if (reader.field == 3)
+            zlibData = reader.ReadBytes();
+        else if (reader.wireType == ProtoReader::LENGTH_DELIMITED)
+            throw std::runtime_error("Unsupported osm pbf file: only zlib compressed or raw blobs are supported");
+        else
+            reader.Skip();
+    }
+
+    if (!raw.empty())
+        return std::string(raw);
+
+    std::string block(rawSize, '\0');
+    if (uncompress(reinterpret_cast<Bytef *>(block.data()), &rawSize, reinterpret_cast<const Bytef *>(zlibData.data()),
+                   zlibData.size()) != Z_OK) {
+        throw std::runtime_error("Malformed osm pbf file: failed to decompress blob");
+    }
+    block.resize(rawSize);
+    return block;
+}
+
+/// Decodes the filtered blobs in parallel, each worker thread reads its blobs through its own file stream
+static void forEachBlob(const std::string &filePath, const std::vector<BlobLocation> &blobs,
+                        const std::vector<bool> &blobFilter,
+                        const std::function<void(int blobIndex, std::string_view block)> &handler) {
+    std::atomic<int> nextBlob = 0;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < std::max(1u, std::thread::hardware_concurrency()); ++t) {
+        workers.emplace_back([&] {
+            try {
+                std::ifstream stream(filePath, std::ios::binary);
+                for (int i = nextBlob++; i < blobs.size(); i = nextBlob++) {
+                    if (!blobFilter[i])
+                        continue;
+
+                    const std::string block = readBlob(stream, blobs[i]);
+                    handler(i, block);
+                }
+            } catch (...) {
+                const std::lock_guard lock(errorMutex);
+                error = std::current_exception();
+                nextBlob = static_cast<int>(blobs.size()); // stops the other workers
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+/// Returns the string table of a primitive block as views into the block
+static std::vector<std::string_view> parseStringTable(const std::string_view block) {
+    std::vector<std::string_view> strings;
+
+    // PrimitiveBlock: stringtable = 1
+    ProtoReader blockReader(block);
+    while (blockReader.Next()) {
+        if (blockReader.field != 1) {
+            blockReader.Skip();
+            continue;
+        }
+
+        // StringTable: s = 1
+        ProtoReader tableReader(blockReader.ReadBytes());
+        while (tableReader.Next()) {
+            if (tableReader.field == 1)
+                strings.push_back(tableReader.ReadBytes());
+            else
+                tableReader.Skip();
+        }
+    }
+
+    return strings;
+}
+
+/// @return true if the highway type is a road that can be driven on by a car (or is a race track)
+static bool isDrivableHighway(const std::string_view highway) {
+    static constexpr std::array<std::string_view, 19> drivable = {
+            "motorway",    "motorway_link",  "trunk",         "trunk_link",   "primary",
+            "primary_link", "secondary",     "secondary_link", "tertiary",    "tertiary_link",
+            "unclassified", "residential",   "living_street",  "service",     "road",
+            "track",        "raceway",       "busway",         "escape",
+    };
+    return std::ranges::find(drivable, highway) != drivable.end();
+}
+
+static WayChunk parseWays(const std::string_view block) {
+    WayChunk chunk;
+    const std::vector<std::string_view> strings = parseStringTable(block);
+
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> values;
+    std::vector<int64_t> refs;
+
+    // PrimitiveBlock: primitivegroup = 2
+    ProtoReader blockReader(block);
+    while (blockReader.Next()) {
+        if (blockReader.field != 2) {
+            blockReader.Skip();
+            continue;
+        }
+
+        // PrimitiveGroup: nodes = 1, dense = 2, ways = 3
+        ProtoReader groupReader(blockReader.ReadBytes());
+        while (groupReader.Next()) {
+            if (groupReader.field == 1 || groupReader.field == 2) {
+                chunk.hasNodes = true;
+                groupReader.Skip();
+                continue;
+            }
+            if (groupReader.field != 3) {
+                groupReader.Skip();
+                continue;
+            }
+
+            // Way: keys = 2, vals = 3, refs = 8 (delta coded)
+            keys.clear();
+            values.clear();
+            refs.clear();
+            ProtoReader wayReader(groupReader.ReadBytes());
+            while (wayReader.Next()) {
+                if (wayReader.field == 2)
+                    wayReader.ReadRepeatedVarint(keys);
+                else if (wayReader.field == 3)
+                    wayReader.ReadRepeatedVarint(values);
+                else if (wayReader.field == 8)
+                    wayReader.ReadRepeatedSVarint(refs);
+                else
+                    wayReader.Skip();
+            }
+
+            std::string_view highway, oneway, junction, area;
+            for (int i = 0; i < std::min(keys.size(), values.size()); ++i) {
+                if (keys[i] >= strings.size() || values[i] >= strings.size())
+                    continue;
+
+                const std::string_view key = strings[keys[i]];
+                if (key == "highway")
+                    highway = strings[values[i]];
+                else if (key == "oneway")
+                    oneway = strings[values[i]];
+                else if (key == "junction")
+                    junction = strings[values[i]];
+                else if (key == "area")
+                    area = strings[values[i]];
+            }
+
+            if (refs.size() < 2 || !isDrivableHighway(highway) || area == "yes")
+                continue;
+
+            // motorways and roundabouts are oneway if not tagged otherwise
+            WayDirection direction = WayDirection::BOTH;
+            if (oneway == "yes" || oneway == "true" || oneway == "1")
+                direction = WayDirection::FORWARD;
+            else if (oneway == "-1" || oneway == "reverse")
+                direction = WayDirection::BACKWARD;
+            else if (oneway.empty() && (highway == "motorway" || junction == "roundabout"))
+                direction = WayDirection::FORWARD;
+
+            int64_t nodeId = 0;
+            for (const int64_t delta: refs) {
+                nodeId += delta;
+                chunk.refs.push_back(nodeId);
+            }
+            chunk.wayEnds.push_back(static_cast<uint32_t>(chunk.refs.size()));
+            chunk.directions.push_back(direction);
+        }
+    }
+
+    return chunk;
+}
+
+static void parseNodes(const std::string_view block, const std::vector<int64_t> &nodeIds, Location *locations,
+                       std::atomic<uint8_t> *found) {
+    const auto storeNode = [&](const int64_t nodeId, const double latitude, const double longitude) {
+        if (const int64_t index = findNodeIndex(nodeIds, nodeId); index != -1) {
+            locations[index] = {latitude, longitude};
+            found[index] = 1;
+        }
+    };
+
+    // PrimitiveBlock: granularity = 17, lat_offset = 19, lon_offset = 20
+    // the coordinate parameters can follow the groups, so they are read first
+    BlockCoordinates coordinates;
+    ProtoReader blockReader(block);
+    while (blockReader.Next()) {
+        if (blockReader.field == 17)
+            coordinates.granularity = static_cast<int64_t>(blockReader.ReadVarint());
+        else if (blockReader.field == 19)
+            coordinates.latOffset = static_cast<int64_t>(blockReader.ReadVarint());
+        else if (blockReader.field == 20)
+            coordinates.lonOffset = static_cast<int64_t>(blockReader.ReadVarint());
+        else
+            blockReader.Skip();
+    }
+
+    std::vector<int64_t> ids;
+    std::vector<int64_t> lats;
+    std::vector<int64_t> lons;
+
+    // PrimitiveBlock: primitivegroup = 2
+    blockReader = ProtoReader(block);
+    while (blockReader.Next()) {
+        if (blockReader.field != 2) {
+            blockReader.Skip();
+            continue;
+        }
+
+        // PrimitiveGroup: nodes = 1, dense = 2
+        ProtoReader groupReader(blockReader.ReadBytes());
+        while (groupReader.Next()) {
+            if (groupReader.field == 1) {
+                // Node: id = 1, lat = 8, lon = 9
+                int64_t id = 0, lat = 0, lon = 0;
+                ProtoReader nodeReader(groupReader.ReadBytes());
+                while (nodeReader.Next()) {
+                    if (nodeReader.field == 1)
+                        id = nodeReader.ReadSVarint();
+                    else if (nodeReader.field == 8)
+                        lat = nodeReader.ReadSVarint();
+                    else if (nodeReader.field == 9)
+                        lon = nodeReader.ReadSVarint();
+                    else
+                        nodeReader.Skip();
+                }
+                storeNode(id, coordinates.ToDegrees(lat, coordinates.latOffset),
+                          coordinates.ToDegrees(lon, coordinates.lonOffset));
+            } else if (groupReader.field == 2) {
+                // DenseNodes: id = 1, lat = 8, lon = 9 (all delta coded)
+                ids.clear();
+                lats.clear();
+                lons.clear();
+                ProtoReader denseReader(groupReader.ReadBytes());
+                while (denseReader.Next()) {
+                    if (denseReader.field == 1)
+                        denseReader.ReadRepeatedSVarint(ids);
+                    else if (denseReader.field == 8)
+                        denseReader.ReadRepeatedSVarint(lats);
+                    else if (denseReader.field == 9)
+                        denseReader.ReadRepeatedSVarint(lons);
+                    else
+                        denseReader.Skip();
+                }
+
+                int64_t id = 0, lat = 0, lon = 0;
+                for (int i = 0; i < std::min({ids.size(), lats.size(), lons.size()}); ++i) {
+                    id += ids[i];
+                    lat += lats[i];
+                    lon += lons[i];
+                    storeNode(id, coordinates.ToDegrees(lat, coordinates.latOffset),
+                              coordinates.ToDegrees(lon, coordinates.lonOffset));
+                }
+            } else {
+                groupReader.Skip();
+            }
+        }
+    }
+}
+
+/// @return index of the node id in the sorted node ids or -1 if it is not contained
+static int64_t findNodeIndex(const std::vector<int64_t> &nodeIds, const int64_t nodeId) {
+    const auto it = std::ranges::lower_bound(nodeIds, nodeId);
+    if (it == nodeIds.end() || *it != nodeId)
+        return -1;
+
+    return it - nodeIds.begin();
+}
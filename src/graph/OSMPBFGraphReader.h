@@ -0,0 +1,18 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef OSMPBFGRAPHREADER_H
+#define OSMPBFGRAPHREADER_H
+#include <string>
+
+#include "BasicGraph.h"
+
+/// Builds a road graph directly from an OpenStreetMap .osm.pbf file without the intermediate .fmi text file
+class OSMPBFGraphReader {
+public:
+    static BasicGraph read(const std::string &filePath);
+};
+
+
+#endif //OSMPBFGRAPHREADER_H
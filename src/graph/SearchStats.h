@@ -0,0 +1,55 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <chrono>
+#include <cstdint>
+
+/// Counters describing the work done by a single path query
+struct SearchStats {
+    int64_t settledNodes = 0;
+    int64_t relaxedEdges = 0;
+    int64_t heapPushes = 0;
+    int64_t heapPops = 0;
+    std::chrono::nanoseconds resetTime{0}; // time spent (re)initializing the search workspace
+    std::chrono::nanoseconds totalTime{0};
+};
+
+/// Compile time policy for path queries that records nothing, all calls get optimized away
+struct NoSearchStats {
+    void StartQuery() {}
+    void EndQuery() {}
+    void StartReset() {}
+    void EndReset() {}
+    void OnHeapPush() {}
+    void OnHeapPop() {}
+    void OnSettle() {}
+    void OnRelax() {}
+};
+
+/// Compile time policy for path queries that records all counters into a SearchStats object
+class SearchStatsRecorder {
+public:
+    explicit SearchStatsRecorder(SearchStats &stats) : m_rStats(stats) {}
+
+    void StartQuery() { m_QueryStart = Clock::now(); }
+    void EndQuery() { m_rStats.totalTime += Clock::now() - m_QueryStart; }
+    void StartReset() { m_ResetStart = Clock::now(); }
+    void EndReset() { m_rStats.resetTime += Clock::now() - m_ResetStart; }
+    void OnHeapPush() { m_rStats.heapPushes++; }
+    void OnHeapPop() { m_rStats.heapPops++; }
+    void OnSettle() { m_rStats.settledNodes++; }
+    void OnRelax() { m_rStats.relaxedEdges++; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    SearchStats &m_rStats;
+    Clock::time_point m_QueryStart;
+    Clock::time_point m_ResetStart;
+};
+
+#endif //SEARCHSTATS_H
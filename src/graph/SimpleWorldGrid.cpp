@@ -7,16 +7,29 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMPLEWORLDGRID_SSE2
+#include <emmintrin.h>
+#endif
 
 static Location clampLocation(const Location &location);
 
+static void findClosestInRange(const double *latitudes, const double *longitudes, int startIndex, int endIndex,
+                               const Location &location, double &minSqrDist, int &minIndex);
+
 SimpleWorldGrid::SimpleWorldGrid(const IGraph &graph, const float resolution)
     : m_rGraph(graph),
       m_Resolution(resolution),
       m_CellCountX(std::floor(360 / resolution)),
       m_CellCountY(std::floor(180 / resolution)),
-      m_pNodeIndices(std::make_unique<int[]>(graph.GetNodeCount())),
-      m_pCellLookupIndices(std::make_unique<int[]>(m_CellCountX * m_CellCountY + 1)) {
+      m_pNodeIndices(MakeHugePageArray<int>(graph.GetNodeCount())),
+      m_pCellLookupIndices(MakeHugePageArray<int>(m_CellCountX * m_CellCountY + 1)),
+      m_pLatitudes(MakeHugePageArray<double>(graph.GetNodeCount())),
+      m_pLongitudes(MakeHugePageArray<double>(graph.GetNodeCount())) {
     // -- fill array with indices for the nodes --
     std::vector<std::pair<int, int> > sorting;
     sorting.reserve(graph.GetNodeCount());
@@ -30,6 +43,11 @@ SimpleWorldGrid::SimpleWorldGrid(const IGraph &graph, const float resolution)
     });
     for (int i = 0; i < graph.GetNodeCount(); ++i) {
         m_pNodeIndices[i] = sorting[i].first;
+
+        // copy locations in cell order so the nodes of a cell lie contiguous in memory for the distance scan
+        const auto [latitude, longitude] = graph.GetLocation(sorting[i].first);
+        m_pLatitudes[i] = latitude;
+        m_pLongitudes[i] = longitude;
     }
 
     // -- iterate over all nodes now sorted by their cells and fill the offset table --
@@ -69,23 +87,20 @@ int SimpleWorldGrid::GetClosestNode(const Location location) const {
         GetCellIndexForLocation({location.latitude + m_Resolution, location.longitude + m_Resolution}),
     };
 
-    double minDist = std::numeric_limits<double>::max();
-    int minDistNodeIndex = -1;
+    double minSqrDist = std::numeric_limits<double>::max();
+    int minIndex = -1;
 
-    for (const int cellIndex : cellsToCheck) {
-        for (const int nodeIndex: GetNodeIndicesInCell(cellIndex)) {
-            auto [nodeLatitude, nodeLongitude] = m_rGraph.GetLocation(nodeIndex);
-            const double sqrDist = std::pow(location.latitude - nodeLatitude, 2) +
-                                   std::pow(location.longitude - nodeLongitude, 2);
+    for (const int cellIndex: cellsToCheck) {
+        findClosestInRange(m_pLatitudes.get(), m_pLongitudes.get(), m_pCellLookupIndices[cellIndex],
+                           m_pCellLookupIndices[cellIndex + 1], location, minSqrDist, minIndex);
+    }
 
-            if (sqrDist < minDist) {
-                minDist = sqrDist;
-                minDistNodeIndex = nodeIndex;
-            }
-        }
+    if (minIndex == -1) {
+        // no nodes in any of the checked cells
+        return -1;
     }
 
-    return minDistNodeIndex;
+    return m_pNodeIndices[minIndex];
 }
 
 int SimpleWorldGrid::GetCellIndexForLocation(const Location &location) const {
@@ -96,17 +111,92 @@ int SimpleWorldGrid::GetCellIndexForLocation(const Location &location) const {
     return xIndex * m_CellCountY + yIndex;
 }
 
-std::vector<int> SimpleWorldGrid::GetNodeIndicesInCell(const int cellIndex) const {
-    const int startIndex = m_pCellLookupIndices[cellIndex];
-    const int nextNodeStartIndex = m_pCellLookupIndices[cellIndex + 1];
+/**
+ * Searches the location arrays in [startIndex, endIndex) for an entry closer to location than minSqrDist
+ * @note Uses the squared euclidean distance in degrees, same as the grid cells
+ * @param minSqrDist current smallest squared distance, gets updated if a closer entry is found
+ * @param minIndex index into the location arrays of the closest entry, gets updated if a closer entry is found
+ */
+static void findClosestInRange(const double *latitudes, const double *longitudes, const int startIndex,
+                               const int endIndex, const Location &location, double &minSqrDist, int &minIndex) {
+    int i = startIndex;
+
+#if defined(__AVX2__)
+    // four candidates per iteration, keeping the best distance and its index per lane
+    if (endIndex - i >= 4) {
+        const __m256d queryLat = _mm256_set1_pd(location.latitude);
+        const __m256d queryLon = _mm256_set1_pd(location.longitude);
+        const __m256d step = _mm256_set1_pd(4);
+        __m256d laneIndices = _mm256_setr_pd(i, i + 1, i + 2, i + 3);
+        __m256d bestDists = _mm256_set1_pd(minSqrDist);
+        __m256d bestIndices = _mm256_set1_pd(-1);
+
+        for (; i + 4 <= endIndex; i += 4) {
+            const __m256d dLat = _mm256_sub_pd(_mm256_loadu_pd(latitudes + i), queryLat);
+            const __m256d dLon = _mm256_sub_pd(_mm256_loadu_pd(longitudes + i), queryLon);
+            const __m256d sqrDists = _mm256_add_pd(_mm256_mul_pd(dLat, dLat), _mm256_mul_pd(dLon, dLon));
+
+            const __m256d closer = _mm256_cmp_pd(sqrDists, bestDists, _CMP_LT_OQ);
+            bestDists = _mm256_blendv_pd(bestDists, sqrDists, closer);
+            bestIndices = _mm256_blendv_pd(bestIndices, laneIndices, closer);
+            laneIndices = _mm256_add_pd(laneIndices, step);
+        }
 
-    std::vector<int> indices;
-    indices.reserve(nextNodeStartIndex - startIndex);
-    for (int i = startIndex; i < nextNodeStartIndex; ++i) {
-        indices.push_back(m_pNodeIndices[i]);
+        alignas(32) double dists[4];
+        alignas(32) double indices[4];
+        _mm256_store_pd(dists, bestDists);
+        _mm256_store_pd(indices, bestIndices);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (indices[lane] >= 0 && dists[lane] < minSqrDist) {
+                minSqrDist = dists[lane];
+                minIndex = static_cast<int>(indices[lane]);
+            }
+        }
     }
+#elif defined(SIMPLEWORLDGRID_SSE2)
+    // two candidates per iteration, SSE2 has no blend instruction so selection is done with bit masks
+    if (endIndex - i >= 2) {
+        const __m128d queryLat = _mm_set1_pd(location.latitude);
+        const __m128d queryLon = _mm_set1_pd(location.longitude);
+        const __m128d step = _mm_set1_pd(2);
+        __m128d laneIndices = _mm_setr_pd(i, i + 1);
+        __m128d bestDists = _mm_set1_pd(minSqrDist);
+        __m128d bestIndices = _mm_set1_pd(-1);
+
+        for (; i + 2 <= endIndex; i += 2) {
+            const __m128d dLat = _mm_sub_pd(_mm_loadu_pd(latitudes + i), queryLat);
+            const __m128d dLon = _mm_sub_pd(_mm_loadu_pd(longitudes + i), queryLon);
+            const __m128d sqrDists = _mm_add_pd(_mm_mul_pd(dLat, dLat), _mm_mul_pd(dLon, dLon));
+
+            const __m128d closer = _mm_cmplt_pd(sqrDists, bestDists);
+            bestDists = _mm_or_pd(_mm_and_pd(closer, sqrDists), _mm_andnot_pd(closer, bestDists));
+            bestIndices = _mm_or_pd(_mm_and_pd(closer, laneIndices), _mm_andnot_pd(closer, bestIndices));
+            laneIndices = _mm_add_pd(laneIndices, step);
+        }
 
-    return indices;
+        alignas(16) double dists[2];
+        alignas(16) double indices[2];
+        _mm_store_pd(dists, bestDists);
+        _mm_store_pd(indices, bestIndices);
+        for (int lane = 0; lane < 2; ++lane) {
+            if (indices[lane] >= 0 && dists[lane] < minSqrDist) {
+                minSqrDist = dists[lane];
+                minIndex = static_cast<int>(indices[lane]);
+            }
+        }
+    }
+#endif
+
+    // remaining candidates that do not fill a whole vector (or all of them without simd support)
+    for (; i < endIndex; ++i) {
+        const double dLat = latitudes[i] - location.latitude;
+        const double dLon = longitudes[i] - location.longitude;
+
+        if (const double sqrDist = dLat * dLat + dLon * dLon; sqrDist < minSqrDist) {
+            minSqrDist = sqrDist;
+            minIndex = i;
+        }
+    }
 }
 
 /**
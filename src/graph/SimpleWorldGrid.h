@@ -4,8 +4,7 @@
 
 #ifndef SIMPLEWORLDGRID_H
 #define SIMPLEWORLDGRID_H
-#include <memory>
-
+#include "HugePageArray.h"
 #include "IGrid.h"
 
 
@@ -20,12 +19,13 @@ private:
     const float m_Resolution;
     const int m_CellCountX;
     const int m_CellCountY;
-    const std::unique_ptr<int[]> m_pNodeIndices;
-    const std::unique_ptr<int[]> m_pCellLookupIndices;
+    const HugePageArray<int> m_pNodeIndices;
+    const HugePageArray<int> m_pCellLookupIndices;
+    // structure of arrays copy of the node locations in the same (cell sorted) order as m_pNodeIndices
+    const HugePageArray<double> m_pLatitudes;
+    const HugePageArray<double> m_pLongitudes;
 
     [[nodiscard]] int GetCellIndexForLocation(const Location &location) const;
-
-    [[nodiscard]] std::vector<int> GetNodeIndicesInCell(int cellIndex) const;
 };
 
 
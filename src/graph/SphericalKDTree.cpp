@@ -0,0 +1,242 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "SphericalKDTree.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <numeric>
+#include <thread>
+
+#include "GeoUtils.h"
+
+static constexpr int LEAF_SIZE = 8; // ranges of this size get scanned linearly
+static constexpr int MIN_BATCH_SIZE_PER_THREAD = 1024;
+
+static double chordToMeters(double sqrChord);
+
+static double metersToSqrChord(double meters);
+
+namespace {
+    struct ClosestVisitor {
+        double bestSqrDist = std::numeric_limits<double>::max();
+        int bestIndex = -1;
+
+        [[nodiscard]] double MaxSqrDistance() const { return bestSqrDist; }
+
+        void Visit(const int index, const double sqrDist) {
+            if (sqrDist < bestSqrDist) {
+                bestSqrDist = sqrDist;
+                bestIndex = index;
+            }
+        }
+    };
+
+    struct KNearestVisitor {
+        size_t count;
+        std::vector<std::pair<double, int> > heap; // max heap of the closest entries found so far
+
+        [[nodiscard]] double MaxSqrDistance() const {
+            return heap.size() < count ? std::numeric_limits<double>::max() : heap.front().first;
+        }
+
+        void Visit(const int index, const double sqrDist) {
+            if (heap.size() < count) {
+                heap.emplace_back(sqrDist, index);
+                std::ranges::push_heap(heap);
+            } else if (sqrDist < heap.front().first) {
+                std::ranges::pop_heap(heap);
+                heap.back() = {sqrDist, index};
+                std::ranges::push_heap(heap);
+            }
+        }
+    };
+
+    struct RadiusVisitor {
+        double maxSqrDist;
+        std::vector<std::pair<double, int> > found;
+
+        [[nodiscard]] double MaxSqrDistance() const { return maxSqrDist; }
+
+        void Visit(const int index, const double sqrDist) {
+            if (sqrDist <= maxSqrDist)
+                found.emplace_back(sqrDist, index);
+        }
+    };
+} // namespace
+
+SphericalKDTree::SphericalKDTree(const IGraph &graph) :
+    m_NodeCount(graph.GetNodeCount()),
+    m_pPoints(MakeHugePageArray<Point3>(graph.GetNodeCount())),
+    m_pNodeIndices(MakeHugePageArray<int>(graph.GetNodeCount())),
+    m_pSplitAxes(MakeHugePageArray<uint8_t>(graph.GetNodeCount())) {
+    // -- build the tree on a permutation of the node indices --
+    std::vector<Point3> points;
+    points.reserve(m_NodeCount);
+    for (int i = 0; i < m_NodeCount; ++i) {
+        points.push_back(ToUnitSphere(graph.GetLocation(i)));
+    }
+
+    std::vector<int> order(m_NodeCount);
+    std::iota(order.begin(), order.end(), 0);
+    Build(order, points, 0, m_NodeCount);
+
+    // -- store points in tree order so every range of the tree lies contiguous in memory --
+    for (int i = 0; i < m_NodeCount; ++i) {
+        m_pPoints[i] = points[order[i]];
+        m_pNodeIndices[i] = order[i];
+    }
+}
+
+int SphericalKDTree::GetClosestNode(const Location location) const {
+    ClosestVisitor visitor;
+    Search(0, m_NodeCount, ToUnitSphere(location), visitor);
+
+    return visitor.bestIndex == -1 ? -1 : m_pNodeIndices[visitor.bestIndex];
+}
+
+std::vector<NodeDistance> SphericalKDTree::GetClosestNodes(const Location location, const int count) const {
+    if (count <= 0)
+        return {};
+
+    KNearestVisitor visitor{static_cast<size_t>(count), {}};
+    visitor.heap.reserve(count);
+    Search(0, m_NodeCount, ToUnitSphere(location), visitor);
+
+    std::ranges::sort_heap(visitor.heap);
+
+    std::vector<NodeDistance> nodes;
+    nodes.reserve(visitor.heap.size());
+    for (const auto &[sqrDist, index]: visitor.heap) {
+        nodes.emplace_back(m_pNodeIndices[index], chordToMeters(sqrDist));
+    }
+    return nodes;
+}
+
+std::vector<NodeDistance> SphericalKDTree::GetNodesInRadius(const Location location, const double radius) const {
+    RadiusVisitor visitor{metersToSqrChord(radius), {}};
+    Search(0, m_NodeCount, ToUnitSphere(location), visitor);
+
+    std::ranges::sort(visitor.found);
+
+    std::vector<NodeDistance> nodes;
+    nodes.reserve(visitor.found.size());
+    for (const auto &[sqrDist, index]: visitor.found) {
+        nodes.emplace_back(m_pNodeIndices[index], chordToMeters(sqrDist));
+    }
+    return nodes;
+}
+
+std::vector<int> SphericalKDTree::GetClosestNodes(const std::span<const Location> locations) const {
+    std::vector<int> nodes(locations.size());
+
+    const auto snapRange = [this, &locations, &nodes](const size_t start, const size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            nodes[i] = GetClosestNode(locations[i]);
+        }
+    };
+
+    const size_t threadCount = std::clamp<size_t>(locations.size() / MIN_BATCH_SIZE_PER_THREAD, 1,
+                                                  std::max(1u, std::thread::hardware_concurrency()));
+    if (threadCount == 1) {
+        snapRange(0, locations.size());
+        return nodes;
+    }
+
+    std::vector<std::thread> workers;
+    const size_t batchSize = (locations.size() + threadCount - 1) / threadCount;
+    for (size_t start = 0; start < locations.size(); start += batchSize) {
+        workers.emplace_back(snapRange, start, std::min(start + batchSize, locations.size()));
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    return nodes;
+}
+
+static double getAxis(const auto &point, const int axis) { return axis == 0 ? point.x : axis == 1 ? point.y : point.z; }
+
+static double sqrDistance(const auto &a, const auto &b) {
+    const double dx = a.x - b.x;
+    const double dy = a.y - b.y;
+    const double dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void SphericalKDTree::Build(std::vector<int> &order, const std::vector<Point3> &points, const int start,
+                            const int end) {
+    if (end - start <= LEAF_SIZE)
+        return;
+
+    // split along the axis with the biggest extend
+    Point3 min{1, 1, 1};
+    Point3 max{-1, -1, -1};
+    for (int i = start; i < end; ++i) {
+        const auto [x, y, z] = points[order[i]];
+        min = {std::min(min.x, x), std::min(min.y, y), std::min(min.z, z)};
+        max = {std::max(max.x, x), std::max(max.y, y), std::max(max.z, z)};
+    }
+    const std::array spreads{max.x - min.x, max.y - min.y, max.z - min.z};
+    const int axis = static_cast<int>(std::ranges::max_element(spreads) - spreads.begin());
+
+    // partition the range around its median
+    const int mid = start + (end - start) / 2;
+    std::nth_element(order.begin() + start, order.begin() + mid, order.begin() + end,
+                     [&points, axis](const int left, const int right) {
+                         return getAxis(points[left], axis) < getAxis(points[right], axis);
+                     });
+    m_pSplitAxes[mid] = static_cast<uint8_t>(axis);
+
+    Build(order, points, start, mid);
+    Build(order, points, mid + 1, end);
+}
+
+template<typename TVisitor>
+void SphericalKDTree::Search(const int start, const int end, const Point3 &query, TVisitor &visitor) const {
+    if (end - start <= LEAF_SIZE) {
+        for (int i = start; i < end; ++i) {
+            visitor.Visit(i, sqrDistance(m_pPoints[i], query));
+        }
+        return;
+    }
+
+    const int mid = start + (end - start) / 2;
+    visitor.Visit(mid, sqrDistance(m_pPoints[mid], query));
+
+    // search the side containing the query first, the other side only if it can contain closer points
+    const int axis = m_pSplitAxes[mid];
+    const double axisDist = getAxis(query, axis) - getAxis(m_pPoints[mid], axis);
+    if (axisDist < 0) {
+        Search(start, mid, query, visitor);
+        if (axisDist * axisDist <= visitor.MaxSqrDistance())
+            Search(mid + 1, end, query, visitor);
+    } else {
+        Search(mid + 1, end, query, visitor);
+        if (axisDist * axisDist <= visitor.MaxSqrDistance())
+            Search(start, mid, query, visitor);
+    }
+}
+
+SphericalKDTree::Point3 SphericalKDTree::ToUnitSphere(const Location &location) {
+    const double lat = degreesToRadians(location.latitude);
+    const double lon = degreesToRadians(location.longitude);
+    return {std::cos(lat) * std::cos(lon), std::cos(lat) * std::sin(lon), std::sin(lat)};
+}
+
+/// Converts the squared straight line distance between two points on the unit sphere into the great circle distance
+static double chordToMeters(const double sqrChord) {
+    const double chord = std::sqrt(sqrChord);
+    return 2 * EARTH_RADIUS_METERS * std::asin(std::min(chord * .5, 1.));
+}
+
+/// Converts a great circle distance into the squared straight line distance between the points on the unit sphere
+static double metersToSqrChord(const double meters) {
+    const double angle = std::clamp(meters / EARTH_RADIUS_METERS, 0., std::numbers::pi);
+    const double chord = 2 * std::sin(angle * .5);
+    return chord * chord;
+}
@@ -0,0 +1,59 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef SPHERICALKDTREE_H
+#define SPHERICALKDTREE_H
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "HugePageArray.h"
+#include "IGrid.h"
+
+struct NodeDistance {
+    int nodeIndex;
+    double distance; // great circle distance in meters
+};
+
+/// Spatial index over the nodes of a graph using their position on the unit sphere, so distances are correct
+/// everywhere on earth including the poles and the antimeridian
+class SphericalKDTree final : public IGrid {
+public:
+    explicit SphericalKDTree(const IGraph &graph);
+
+    /// @return index of the closest node or -1 if the graph has no nodes
+    [[nodiscard]] int GetClosestNode(Location location) const override;
+
+    /// @return up to count closest nodes sorted by distance
+    [[nodiscard]] std::vector<NodeDistance> GetClosestNodes(Location location, int count) const;
+
+    /// @param radius in meters
+    /// @return all nodes within the radius sorted by distance
+    [[nodiscard]] std::vector<NodeDistance> GetNodesInRadius(Location location, double radius) const;
+
+    /// Finds the closest node for each of the locations, large batches are split over multiple threads
+    /// @return index of the closest node for each location
+    [[nodiscard]] std::vector<int> GetClosestNodes(std::span<const Location> locations) const;
+
+private:
+    struct Point3 {
+        double x, y, z;
+    };
+
+    const int m_NodeCount;
+    // tree is stored implicitly: the median of each range [start, end) is the splitting point of the range
+    HugePageArray<Point3> m_pPoints;
+    HugePageArray<int> m_pNodeIndices;
+    HugePageArray<uint8_t> m_pSplitAxes;
+
+    void Build(std::vector<int> &order, const std::vector<Point3> &points, int start, int end);
+
+    template<typename TVisitor>
+    void Search(int start, int end, const Point3 &query, TVisitor &visitor) const;
+
+    [[nodiscard]] static Point3 ToUnitSphere(const Location &location);
+};
+
+
+#endif //SPHERICALKDTREE_H
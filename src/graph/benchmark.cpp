@@ -0,0 +1,144 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BasicGraph.h"
+#include "DijkstraPathfinding.h"
+#include "GraphReader.h"
+#include "HugePageArray.h"
+#include "SimpleWorldGrid.h"
+#include "SphericalKDTree.h"
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct LatencySummary {
+    double meanUs;
+    double medianUs;
+    double p95Us;
+};
+
+LatencySummary Summarize(std::vector<double> &samplesUs);
+
+void PrintSummary(const std::string &name, const LatencySummary &summary);
+
+/**
+ * Measures query latencies on a graph file
+ * Usage: TrackMapperGraphBenchmark <path to fmi or osm.pbf file> [query count] [--no-huge-pages]
+ * @note Run once with and once without '--no-huge-pages' to compare the effect of huge page backed graph arrays
+ */
+int main(const int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <path to fmi or osm.pbf file> [query count] [--no-huge-pages]"
+                  << std::endl;
+        return 1;
+    }
+
+    const std::string filePath = argv[1];
+    int queryCount = 100;
+    for (int i = 2; i < argc; ++i) {
+        if (const std::string arg = argv[i]; arg == "--no-huge-pages") {
+            SetHugePagesEnabled(false);
+        } else {
+            queryCount = std::stoi(arg);
+        }
+    }
+
+    const BasicGraph graph = GraphReader::read(filePath);
+    const SimpleWorldGrid grid(graph, 0.01);
+    const SphericalKDTree tree(graph);
+    const DijkstraPathfinding dijkstra(graph);
+
+    std::cout << "Huge page backed memory: " << GetHugePageBytes() / (1024 * 1024) << "MB" << std::endl;
+
+    // fixed seed so runs with and without huge pages use the same queries
+    std::mt19937 rng(42);
+    std::uniform_int_distribution nodeDistribution(0, graph.GetNodeCount() - 1);
+    std::uniform_real_distribution offsetDistribution(-0.005, 0.005);
+
+    // -- shortest path queries between random nodes --
+    std::vector<double> pathSamples;
+    pathSamples.reserve(queryCount);
+    SearchStats stats;
+    for (int i = 0; i < queryCount; ++i) {
+        const int start = nodeDistribution(rng);
+        const int target = nodeDistribution(rng);
+
+        const auto startTime = Clock::now();
+        [[maybe_unused]] const auto path = dijkstra.CalculatePath(start, target, stats);
+        const auto endTime = Clock::now();
+
+        pathSamples.push_back(std::chrono::duration<double, std::micro>(endTime - startTime).count());
+    }
+    PrintSummary("Dijkstra", Summarize(pathSamples));
+    if (queryCount > 0) {
+        std::cout << " > per query: " << stats.settledNodes / queryCount << " settled nodes, "
+                  << stats.relaxedEdges / queryCount << " relaxed edges, " << stats.heapPushes / queryCount
+                  << " heap pushes, "
+                  << std::chrono::duration<double, std::micro>(stats.resetTime).count() / queryCount
+                  << "us workspace reset" << std::endl;
+    }
+
+    // -- closest node queries slightly offset from random nodes --
+    std::vector<Location> locations;
+    locations.reserve(queryCount * 100);
+    for (int i = 0; i < queryCount * 100; ++i) {
+        auto [latitude, longitude] = graph.GetLocation(nodeDistribution(rng));
+        locations.push_back({latitude + offsetDistribution(rng), longitude + offsetDistribution(rng)});
+    }
+
+    const auto measureQueries = [&locations](const auto &query) {
+        std::vector<double> samples;
+        samples.reserve(locations.size());
+        for (const auto &location: locations) {
+            const auto startTime = Clock::now();
+            query(location);
+            const auto endTime = Clock::now();
+
+            samples.push_back(std::chrono::duration<double, std::micro>(endTime - startTime).count());
+        }
+        return Summarize(samples);
+    };
+
+    PrintSummary("Closest node (grid)",
+                 measureQueries([&grid](const Location location) { (void) grid.GetClosestNode(location); }));
+    PrintSummary("Closest node (kd-tree)",
+                 measureQueries([&tree](const Location location) { (void) tree.GetClosestNode(location); }));
+    PrintSummary("10 nearest (kd-tree)",
+                 measureQueries([&tree](const Location location) { (void) tree.GetClosestNodes(location, 10); }));
+    PrintSummary("500m radius (kd-tree)",
+                 measureQueries([&tree](const Location location) { (void) tree.GetNodesInRadius(location, 500); }));
+
+    const auto batchStartTime = Clock::now();
+    [[maybe_unused]] const auto nodes = tree.GetClosestNodes(locations);
+    const auto batchTime = std::chrono::duration<double>(Clock::now() - batchStartTime).count();
+    std::cout << "Batch snapping: " << static_cast<double>(locations.size()) / batchTime << " locations/s" << std::endl;
+
+    return 0;
+}
+
+LatencySummary Summarize(std::vector<double> &samplesUs) {
+    if (samplesUs.empty())
+        return {0, 0, 0};
+
+    std::ranges::sort(samplesUs);
+
+    double sum = 0;
+    for (const double sample: samplesUs) {
+        sum += sample;
+    }
+
+    return {sum / static_cast<double>(samplesUs.size()), samplesUs[samplesUs.size() / 2],
+            samplesUs[samplesUs.size() * 95 / 100]};
+}
+
+void PrintSummary(const std::string &name, const LatencySummary &summary) {
+    std::cout << name << ": mean " << summary.meanUs << "us, median " << summary.medianUs << "us, p95 "
+              << summary.p95Us << "us" << std::endl;
+}
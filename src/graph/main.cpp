@@ -4,7 +4,7 @@
 
 #include "BasicGraph.h"
 #include "DijkstraPathfinding.h"
-#include "FMIGraphreader.h"
+#include "GraphReader.h"
 
 void PrintGraph(const BasicGraph &graph);
 
@@ -13,11 +13,11 @@ void QueryGraph(const BasicGraph &graph);
 void QueryShortestPath(const BasicGraph &graph);
 
 int main() {
-    std::cout << "Enter Path to fmi file:" << std::endl;
+    std::cout << "Enter Path to fmi or osm.pbf file:" << std::endl;
 
     std::string filePath;
     std::cin >> filePath;
-    const BasicGraph graph = FMIGraphReader::read(filePath);
+    const BasicGraph graph = GraphReader::read(filePath);
 
     bool run = true;
     while (run) {
@@ -6,12 +6,27 @@
 
 #include <gdal_alg.h>
 #include <gdal_priv.h>
+#include <gdalwarper.h>
 #include <ogr_spatialref.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 namespace TrackMapper::Raster {
 
+    static void registerDrivers();
+    static void setNativeValueType(RasterValues &values, GDALDataType type);
+    template<typename T>
+    static constexpr GDALDataType getGDALDataType();
+    static int findOverviewLevel(GDALDataset *pSrc, GDALDataset *pDst, const ProjectionWrapper &srcProjRef,
+                                 const ProjectionWrapper &dstProjRef);
+
     // ----- ProjectionWrapper -----
 
     ProjectionWrapper::ProjectionWrapper() = default;
@@ -37,8 +52,7 @@ namespace TrackMapper::Raster {
     };
 
     GDALDatasetWrapper::GDALDatasetWrapper(const std::string &filepath) : mTransform(), mProjRef{""} {
-        CPLSetConfigOption("PROJ_LIB", "./proj");
-        GDALAllRegister();
+        registerDrivers();
 
         auto pDataset = GDALDatasetUniquePtr(GDALDataset::FromHandle(GDALOpen(filepath.c_str(), GA_ReadOnly)));
 
@@ -79,30 +93,214 @@ namespace TrackMapper::Raster {
         return pImpl->pDataset->GetRasterBand(1)->GetYSize();
     }
 
-    const std::vector<float> &GDALDatasetWrapper::GetData() {
+    int64_t GDALDatasetWrapper::GetPixelCount() const { return static_cast<int64_t>(GetSizeX()) * GetSizeY(); }
+
+    RasterValueEncoding GDALDatasetWrapper::GetValueEncoding() const {
+        RasterValueEncoding encoding;
+        if (invalid)
+            return encoding;
+
+        const auto band = pImpl->pDataset->GetRasterBand(1);
+        int hasValue;
+        if (const double scale = band->GetScale(&hasValue); hasValue) {
+            encoding.scale = scale;
+        }
+        if (const double offset = band->GetOffset(&hasValue); hasValue) {
+            encoding.offset = offset;
+        }
+        encoding.noData = band->GetNoDataValue(&hasValue);
+        encoding.hasNoData = hasValue != 0;
+        return encoding;
+    }
+
+    const RasterBuffer &GDALDatasetWrapper::GetData() {
         if (invalid)
             return mData; // will be empty
 
-        if (!mData.empty())
+        if (mData.Size() != 0)
             return mData;
 
         // RasterBand numbering starts with 1
         // see: https://gdal.org/tutorials/raster_api_tut.html#fetching-a-raster-band [2024-08-14]
-        const auto band = pImpl->pDataset->GetRasterBand(1);
-        const int nXSize = band->GetXSize();
-        const int nYSize = band->GetYSize();
+        const int nXSize = GetSizeX();
+        const int nYSize = GetSizeY();
+        if (!ReadWindow(0, 0, nXSize, nYSize, nXSize, nYSize, mData)) {
+            mData.values = std::vector<float>();
+        }
 
-        mData.resize(nXSize * nYSize);
+        return mData;
+    }
 
-        // TODO: make type of data dynamic based on file info
-        band->RasterIO(GF_Read, 0, 0, nXSize, nYSize, mData.data(), nXSize, nYSize, GDT_Float32, 0, 0);
-        // TODO: handle error
+    std::pair<int, int> GDALDatasetWrapper::GetBlockSize() const {
+        if (invalid)
+            return {0, 0};
 
-        return mData;
+        int blockSizeX, blockSizeY;
+        pImpl->pDataset->GetRasterBand(1)->GetBlockSize(&blockSizeX, &blockSizeY);
+        return {blockSizeX, blockSizeY};
+    }
+
+    bool GDALDatasetWrapper::ReadWindow(const double offsetX, const double offsetY, const double sizeX,
+                                        const double sizeY, const int bufSizeX, const int bufSizeY,
+                                        RasterBuffer &buffer) const {
+        if (invalid || offsetX < 0 || offsetY < 0 || sizeX <= 0 || sizeY <= 0 || bufSizeX <= 0 || bufSizeY <= 0 ||
+            offsetX + sizeX > GetSizeX() || offsetY + sizeY > GetSizeY())
+            return false;
+
+        // the integer window has to contain the fractional one, gdal reads the latter if it is marked as valid
+        const int windowX = static_cast<int>(std::floor(offsetX));
+        const int windowY = static_cast<int>(std::floor(offsetY));
+        const int windowSizeX = std::min(static_cast<int>(std::ceil(offsetX + sizeX)), GetSizeX()) - windowX;
+        const int windowSizeY = std::min(static_cast<int>(std::ceil(offsetY + sizeY)), GetSizeY()) - windowY;
+
+        GDALRasterIOExtraArg extraArg;
+        INIT_RASTERIO_EXTRA_ARG(extraArg);
+        extraArg.eResampleAlg = GRIORA_Average;
+        extraArg.bFloatingPointWindowValidity = TRUE;
+        extraArg.dfXOff = offsetX;
+        extraArg.dfYOff = offsetY;
+        extraArg.dfXSize = sizeX;
+        extraArg.dfYSize = sizeY;
+
+        // reads smaller than the window get served from overviews by gdal itself
+        const auto band = pImpl->pDataset->GetRasterBand(1);
+        buffer.encoding = GetValueEncoding();
+        setNativeValueType(buffer.values, band->GetRasterDataType());
+        return std::visit(
+                [&](auto &values) {
+                    using T = typename std::decay_t<decltype(values)>::value_type;
+                    values.resize(static_cast<size_t>(bufSizeX) * bufSizeY);
+                    return band->RasterIO(GF_Read, windowX, windowY, windowSizeX, windowSizeY, values.data(), bufSizeX,
+                                          bufSizeY, getGDALDataType<T>(), 0, 0, &extraArg) == CE_None;
+                },
+                buffer.values);
     }
 
     const ProjectionWrapper &GDALDatasetWrapper::GetProjectionRef() const { return mProjRef; }
 
+    std::vector<float> GDALDatasetWrapper::ReadWarped(const ProjectionWrapper &srcProjRef,
+                                                      const ProjectionWrapper &dstProjRef,
+                                                      const GeoTransform &dstTransform, const int sizeX,
+                                                      const int sizeY) const {
+        std::vector<float> data;
+        if (invalid)
+            return data; // will be empty
+
+        const auto memDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+        const auto pDst = GDALDatasetUniquePtr(memDriver->Create("", sizeX, sizeY, 1, GDT_Float32, nullptr));
+        if (!pDst)
+            return data;
+
+        GeoTransform transform = dstTransform;
+        pDst->SetGeoTransform(transform.data());
+        pDst->SetProjection(dstProjRef.Get().c_str());
+
+        // cells not covered by the dataset keep the no data value, as the warper only overwrites covered cells
+        constexpr double noData = std::numeric_limits<float>::quiet_NaN();
+        const auto dstBand = pDst->GetRasterBand(1);
+        dstBand->SetNoDataValue(noData);
+        dstBand->Fill(noData);
+
+        // reading from an overview with about the resolution of the grid avoids reading the full resolution data
+        GDALDataset *pSrc = pImpl->pDataset.get();
+        GDALDatasetUniquePtr pOverview;
+        if (const int level = findOverviewLevel(pSrc, pDst.get(), srcProjRef, dstProjRef); level >= 0) {
+            const std::string levelOption = "OVERVIEW_LEVEL=" + std::to_string(level);
+            const char *const openOptions[] = {levelOption.c_str(), nullptr};
+            constexpr unsigned int openFlags = GDAL_OF_RASTER | GDAL_OF_READONLY;
+            const auto pOverviewHandle = GDALOpenEx(pSrc->GetDescription(), openFlags, nullptr, openOptions, nullptr);
+            pOverview = GDALDatasetUniquePtr(GDALDataset::FromHandle(pOverviewHandle));
+            if (pOverview) {
+                pSrc = pOverview.get();
+            }
+        }
+
+        // the warper processes the grid in chunks and only reads the source window needed for each chunk
+        if (GDALReprojectImage(GDALDataset::ToHandle(pSrc), srcProjRef.Get().c_str(), GDALDataset::ToHandle(pDst.get()),
+                               dstProjRef.Get().c_str(), GRA_Bilinear, 0, 0.125, nullptr, nullptr,
+                               nullptr) != CE_None)
+            return data;
+
+        data.resize(static_cast<size_t>(sizeX) * sizeY);
+        if (dstBand->RasterIO(GF_Read, 0, 0, sizeX, sizeY, data.data(), sizeX, sizeY, GDT_Float32, 0, 0) != CE_None) {
+            data.clear();
+        }
+
+        // the warper copies the stored values, no data cells are NaN already and stay NaN
+        if (const auto encoding = GetValueEncoding(); encoding.scale != 1 || encoding.offset != 0) {
+            for (auto &height: data) {
+                height = static_cast<float>(height * encoding.scale + encoding.offset);
+            }
+        }
+
+        return data;
+    }
+
+
+    std::vector<float> GDALDatasetWrapper::SampleBilinear(const std::vector<double> &x,
+                                                          const std::vector<double> &y) const {
+        constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<float> heights(x.size(), nan);
+        if (invalid)
+            return heights;
+
+        GeoTransform inverse;
+        if (!GDALInvGeoTransform(mTransform.data(), inverse.data()))
+            return heights;
+
+        const auto band = pImpl->pDataset->GetRasterBand(1);
+        const int sizeX = band->GetXSize();
+        const int sizeY = band->GetYSize();
+        int blockSizeX, blockSizeY;
+        band->GetBlockSize(&blockSizeX, &blockSizeY);
+
+        // blocks get read when the first position needs them, neighbouring positions mostly share the same blocks
+        // they stay in the data type of the file and only the sampled pixels get converted to heights
+        std::unordered_map<int64_t, RasterBuffer> blocks;
+        const auto getPixel = [&](const int pixelX, const int pixelY) {
+            const int blockX = pixelX / blockSizeX;
+            const int blockY = pixelY / blockSizeY;
+            const int offsetX = blockX * blockSizeX;
+            const int offsetY = blockY * blockSizeY;
+            const int width = std::min(blockSizeX, sizeX - offsetX); // blocks at the border can be cut off
+            const int height = std::min(blockSizeY, sizeY - offsetY);
+
+            auto [it, inserted] = blocks.try_emplace(static_cast<int64_t>(blockY) << 32 | blockX);
+            auto &block = it->second;
+            if (inserted && !ReadWindow(offsetX, offsetY, width, height, width, height, block)) {
+                block.values = std::vector<float>(); // stays empty, so all its pixels are NaN
+            }
+            if (block.Size() == 0)
+                return nan;
+            return block.GetHeight(static_cast<size_t>(pixelY - offsetY) * width + (pixelX - offsetX));
+        };
+
+        for (size_t i = 0; i < heights.size(); ++i) {
+            // pixel values belong to the pixel centers, so the coordinates get shifted by half a pixel
+            const double pixelX = inverse[0] + x[i] * inverse[1] + y[i] * inverse[2] - .5;
+            const double pixelY = inverse[3] + x[i] * inverse[4] + y[i] * inverse[5] - .5;
+            // negated to also skip NaN positions, positions in the outer half of the border pixels use their value
+            if (!(pixelX >= -.5 && pixelY >= -.5 && pixelX <= sizeX - .5 && pixelY <= sizeY - .5))
+                continue;
+
+            const double clampedX = std::clamp(pixelX, 0., sizeX - 1.);
+            const double clampedY = std::clamp(pixelY, 0., sizeY - 1.);
+            const int x0 = static_cast<int>(clampedX);
+            const int y0 = static_cast<int>(clampedY);
+            const int x1 = std::min(x0 + 1, sizeX - 1);
+            const int y1 = std::min(y0 + 1, sizeY - 1);
+            const double fx = clampedX - x0;
+            const double fy = clampedY - y0;
+
+            // a single NaN neighbour makes the result NaN, so no data pixels don't get blended into valid heights
+            const double top = getPixel(x0, y0) * (1 - fx) + getPixel(x1, y0) * fx;
+            const double bottom = getPixel(x0, y1) * (1 - fx) + getPixel(x1, y1) * fx;
+            heights[i] = static_cast<float>(top * (1 - fy) + bottom * fy);
+        }
+
+        return heights;
+    }
+
 
     // ----- GDALReprojectionTransformer -----
 
@@ -134,6 +332,174 @@ namespace TrackMapper::Raster {
         return GDALReprojectionTransform(pImpl->transformer, 0, 1, x, y, z, nullptr);
     }
 
+    bool GDALReprojectionTransformer::TransformPoints(std::vector<double> &x, std::vector<double> &y) const {
+        if (pImpl->transformer == nullptr)
+            return false;
+
+        const auto count = static_cast<int>(x.size());
+        std::vector<int> success(count);
+        GDALReprojectionTransform(pImpl->transformer, 0, count, x.data(), y.data(), nullptr, success.data());
+        for (int i = 0; i < count; ++i) {
+            if (!success[i]) {
+                x[i] = y[i] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+        return true;
+    }
+
     bool GDALReprojectionTransformer::IsValid() const { return pImpl->transformer != nullptr; }
 
+
+    // ----- Helpers -----
+
+    std::string encodePng(const std::vector<uint8_t> &gray, const std::vector<uint8_t> &alpha, const int sizeX,
+                          const int sizeY) {
+        registerDrivers();
+
+        const auto memDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+        const auto pngDriver = GetGDALDriverManager()->GetDriverByName("PNG");
+        if (memDriver == nullptr || pngDriver == nullptr)
+            return "";
+
+        const auto pImage = GDALDatasetUniquePtr(memDriver->Create("", sizeX, sizeY, 2, GDT_Byte, nullptr));
+        if (!pImage)
+            return "";
+
+        // the png driver can only create copies of existing datasets
+        const auto pixels = const_cast<uint8_t *>(gray.data());
+        const auto alphas = const_cast<uint8_t *>(alpha.data());
+        if (pImage->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, sizeX, sizeY, pixels, sizeX, sizeY, GDT_Byte, 0, 0) !=
+                    CE_None ||
+            pImage->GetRasterBand(2)->RasterIO(GF_Write, 0, 0, sizeX, sizeY, alphas, sizeX, sizeY, GDT_Byte, 0, 0) !=
+                    CE_None)
+            return "";
+        pImage->GetRasterBand(2)->SetColorInterpretation(GCI_AlphaBand);
+
+        // unique name per call, so images can be encoded from multiple threads at the same time
+        static std::atomic<uint64_t> fileCounter = 0;
+        const std::string memFilePath = "/vsimem/trackmapper_" + std::to_string(fileCounter++) + ".png";
+
+        auto pPng = GDALDatasetUniquePtr(pngDriver->CreateCopy(memFilePath.c_str(), pImage.get(), false, nullptr,
+                                                               nullptr, nullptr));
+        if (!pPng) {
+            VSIUnlink(memFilePath.c_str());
+            return "";
+        }
+        pPng = nullptr; // closing flushes the file
+
+        vsi_l_offset length = 0;
+        // takes ownership of the buffer and removes the file
+        const auto buffer = VSIGetMemFileBuffer(memFilePath.c_str(), &length, true);
+        if (buffer == nullptr)
+            return "";
+
+        std::string png(reinterpret_cast<const char *>(buffer), length);
+        VSIFree(buffer);
+        return png;
+    }
+
+    static void registerDrivers() {
+        // registering all drivers is expensive, so it only happens once
+        static std::once_flag registerFlag;
+        std::call_once(registerFlag, [] {
+            CPLSetConfigOption("PROJ_LIB", "./proj");
+            GDALAllRegister();
+        });
+    }
+
+    static int findOverviewLevel(GDALDataset *pSrc, GDALDataset *pDst, const ProjectionWrapper &srcProjRef,
+                                 const ProjectionWrapper &dstProjRef) {
+        const auto band = pSrc->GetRasterBand(1);
+        if (band == nullptr || band->GetOverviewCount() == 0)
+            return -1;
+
+        const std::string srcOption = "SRC_SRS=" + srcProjRef.Get();
+        const std::string dstOption = "DST_SRS=" + dstProjRef.Get();
+        const char *const options[] = {srcOption.c_str(), dstOption.c_str(), nullptr};
+        const auto transformer = GDALCreateGenImgProjTransformer2(
+                GDALDataset::ToHandle(pSrc), GDALDataset::ToHandle(pDst), const_cast<char **>(options));
+        if (transformer == nullptr)
+            return -1;
+
+        // maps the corners of the grid to pixels of the dataset, to find how many dataset pixels fall into one cell
+        const double sizeX = pDst->GetRasterXSize();
+        const double sizeY = pDst->GetRasterYSize();
+        double x[] = {0, sizeX, 0, sizeX};
+        double y[] = {0, 0, sizeY, sizeY};
+        double z[] = {0, 0, 0, 0};
+        int success[] = {0, 0, 0, 0};
+        GDALGenImgProjTransform(transformer, true, 4, x, y, z, success);
+        GDALDestroyGenImgProjTransformer(transformer);
+        if (!success[0] || !success[1] || !success[2] || !success[3])
+            return -1;
+
+        const double srcPixelsX = std::max({x[0], x[1], x[2], x[3]}) - std::min({x[0], x[1], x[2], x[3]});
+        const double srcPixelsY = std::max({y[0], y[1], y[2], y[3]}) - std::min({y[0], y[1], y[2], y[3]});
+        const double ratio = std::min(srcPixelsX / sizeX, srcPixelsY / sizeY);
+
+        // picks the coarsest overview that still has at least the resolution of the grid, like gdalwarp does
+        int level = -1;
+        for (int i = 0; i < band->GetOverviewCount(); ++i) {
+            const auto overview = band->GetOverview(i);
+            const double factor = static_cast<double>(band->GetXSize()) / overview->GetXSize();
+            if (factor > ratio)
+                break;
+            level = i;
+        }
+        return level;
+    }
+
+    /// Switches the values to the vector type matching the data type of a band, keeps them if they already match
+    static void setNativeValueType(RasterValues &values, const GDALDataType type) {
+        const auto set = [&values]<typename T>() {
+            if (!std::holds_alternative<std::vector<T>>(values)) {
+                values = std::vector<T>();
+            }
+        };
+        switch (type) {
+            case GDT_Byte:
+                set.operator()<uint8_t>();
+                break;
+            case GDT_Int16:
+                set.operator()<int16_t>();
+                break;
+            case GDT_UInt16:
+                set.operator()<uint16_t>();
+                break;
+            case GDT_Int32:
+                set.operator()<int32_t>();
+                break;
+            case GDT_UInt32:
+                set.operator()<uint32_t>();
+                break;
+            case GDT_Float64:
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 5, 0)
+            case GDT_Int64: // not exactly representable by float
+            case GDT_UInt64:
+#endif
+                set.operator()<double>();
+                break;
+            default: // float and types that can't be heights, e.g. complex numbers
+                set.operator()<float>();
+        }
+    }
+
+    template<typename T>
+    static constexpr GDALDataType getGDALDataType() {
+        if constexpr (std::is_same_v<T, uint8_t>)
+            return GDT_Byte;
+        else if constexpr (std::is_same_v<T, int16_t>)
+            return GDT_Int16;
+        else if constexpr (std::is_same_v<T, uint16_t>)
+            return GDT_UInt16;
+        else if constexpr (std::is_same_v<T, int32_t>)
+            return GDT_Int32;
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return GDT_UInt32;
+        else if constexpr (std::is_same_v<T, float>)
+            return GDT_Float32;
+        else
+            return GDT_Float64;
+    }
+
 } // namespace TrackMapper::Raster
@@ -6,8 +6,12 @@
 #define GDAL_WRAPPER_H
 
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace TrackMapper::Raster {
@@ -31,6 +35,40 @@ namespace TrackMapper::Raster {
         bool mValid = false;
     };
 
+    /// Values of a raster band in the data type of the file, so e.g. Int16 rasters take half the memory of floats
+    /// @note Files with other data types get read as float or, if float can't represent them exactly, as double
+    using RasterValues = std::variant<std::vector<uint8_t>, std::vector<int16_t>, std::vector<uint16_t>,
+                                      std::vector<int32_t>, std::vector<uint32_t>, std::vector<float>,
+                                      std::vector<double>>;
+
+    /// Describes how the stored values of a raster band translate into heights
+    struct RasterValueEncoding {
+        double scale = 1, offset = 0; // height = value * scale + offset
+        bool hasNoData = false;
+        double noData = 0; // stored value of pixels without data
+
+        /// @return height of the stored value, NaN for pixels without data
+        template<typename T>
+        [[nodiscard]] float ToHeight(const T value) const {
+            if (hasNoData && static_cast<double>(value) == noData)
+                return NAN;
+            return static_cast<float>(static_cast<double>(value) * scale + offset);
+        }
+    };
+
+    /// Pixels of a raster band as stored in the file, converted to heights only when they get accessed
+    struct RasterBuffer {
+        RasterValues values;
+        RasterValueEncoding encoding;
+
+        [[nodiscard]] size_t Size() const { return std::visit([](const auto &v) { return v.size(); }, values); }
+
+        /// @note Converts on every call, loops over many pixels should visit the values once and use ToHeight instead
+        [[nodiscard]] float GetHeight(const size_t index) const {
+            return std::visit([this, index](const auto &v) { return encoding.ToHeight(v[index]); }, values);
+        }
+    };
+
     /// A wrapper around the GDALDatasetUniquePtr class
     class GDALDatasetWrapper {
     public:
@@ -51,16 +89,60 @@ namespace TrackMapper::Raster {
         [[nodiscard]] int GetSizeX() const;
         [[nodiscard]] int GetSizeY() const;
 
+        /// @return number of pixels of the first raster band, which can exceed the range of int for big rasters
+        [[nodiscard]] int64_t GetPixelCount() const;
+
+        /// @return scale, offset and no data value of the first raster band
+        [[nodiscard]] RasterValueEncoding GetValueEncoding() const;
+
         /**
-         * @return vector containing the hight data for each pixel in row major order
+         * @return buffer containing the hight data for each pixel in row major order, empty if reading failed
          * @note The data is in row major (x-axis) order
          * @note At the moment only reading data from the first raster band is supported
-         * @note At the moment only data of type float (GDT_Float32) is supported
+         * @note Keeps the whole raster in memory, prefer forEachRasterWindow for reading big rasters
+         */
+        const RasterBuffer &GetData();
+
+        /// @return width and height in pixels of the blocks the first raster band is stored in, e.g. 256x256 tiles
+        /// or single rows of full width, reads of whole blocks avoid decoding blocks more than once
+        [[nodiscard]] std::pair<int, int> GetBlockSize() const;
+
+        /**
+         * Reads a window of the first raster band without caching it in the wrapper
+         * @param offsetX,offsetY,sizeX,sizeY window in pixels of the dataset, can be fractional for decimated reads
+         * @param bufSizeX,bufSizeY resolution the window gets read at, smaller than the window to decimate it
+         * @param buffer gets bufSizeX * bufSizeY values in row major order, in the data type of the band
+         * @return false if the window is outside the dataset or reading failed
+         * @note Decimated reads use the overview closest to the buffer resolution if the dataset has overviews,
+         * otherwise the pixels of the window get averaged
          */
-        const std::vector<float> &GetData();
+        bool ReadWindow(double offsetX, double offsetY, double sizeX, double sizeY, int bufSizeX, int bufSizeY,
+                        RasterBuffer &buffer) const;
 
         [[nodiscard]] const ProjectionWrapper &GetProjectionRef() const;
 
+        /**
+         * Reads the first raster band reprojected into the given grid
+         * @param srcProjRef Projection of the dataset, can differ from the one stored in the file
+         * @param dstTransform GeoTransform of the grid in the dstProjRef projection
+         * @return vector containing the height of each grid cell in row major order, NaN where the dataset has no data,
+         * empty if reading failed
+         * @note Only reads the window of the dataset covered by the grid, from the overview closest to the resolution
+         * of the grid if the dataset has overviews
+         */
+        [[nodiscard]] std::vector<float> ReadWarped(const ProjectionWrapper &srcProjRef,
+                                                    const ProjectionWrapper &dstProjRef,
+                                                    const GeoTransform &dstTransform, int sizeX, int sizeY) const;
+
+        /**
+         * Samples the first raster band bilinearly at the given positions
+         * @param x,y Positions in the projection of the dataset
+         * @return height at each position, NaN where the position is outside the dataset or next to a no data pixel
+         * @note Only reads the blocks of the dataset containing the positions, each of them once
+         */
+        [[nodiscard]] std::vector<float> SampleBilinear(const std::vector<double> &x,
+                                                        const std::vector<double> &y) const;
+
     private:
         // opaque pointer to avoid including gdal headers
         struct impl;
@@ -70,7 +152,7 @@ namespace TrackMapper::Raster {
 
         GeoTransform mTransform;
         ProjectionWrapper mProjRef;
-        std::vector<float> mData;
+        RasterBuffer mData;
     };
 
     /// A wrapper around GDALCreateReprojectionTransformerEx class and GDALReprojectionTransform function
@@ -81,6 +163,12 @@ namespace TrackMapper::Raster {
 
         [[nodiscard]] bool Transform(double *x, double *y, double *z) const;
 
+        /**
+         * Transforms all points with a single call, which is a lot faster than transforming them one by one
+         * @return false if the transformer is invalid, points that failed to transform get set to NaN
+         */
+        [[nodiscard]] bool TransformPoints(std::vector<double> &x, std::vector<double> &y) const;
+
         [[nodiscard]] bool IsValid() const;
 
     private:
@@ -88,6 +176,13 @@ namespace TrackMapper::Raster {
         struct impl;
         std::unique_ptr<impl> pImpl;
     };
+
+    /**
+     * Encodes a grayscale image with alpha channel using GDALs png driver
+     * @param gray,alpha sizeX * sizeY values in row major order
+     * @return bytes of the png file, empty if encoding failed
+     */
+    std::string encodePng(const std::vector<uint8_t> &gray, const std::vector<uint8_t> &alpha, int sizeX, int sizeY);
 } // namespace TrackMapper::Raster
 
 #endif // GDAL_WRAPPER_H
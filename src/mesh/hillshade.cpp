@@ -0,0 +1,122 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "hillshade.h"
+
+#include <cmath>
+#include <numbers>
+
+namespace TrackMapper::Raster {
+    constexpr double EARTH_RADIUS = 6378137.0; // of the web mercator sphere in meters
+    constexpr double MERCATOR_EXTEND = 2 * std::numbers::pi * EARTH_RADIUS;
+
+    constexpr float LIGHT_AZIMUTH = 315.0f * std::numbers::pi_v<float> / 180.0f; // clockwise from north
+    constexpr float LIGHT_ALTITUDE = 45.0f * std::numbers::pi_v<float> / 180.0f;
+
+    bool isValidTile(const int z, const int x, const int y) {
+        if (z < 0 || z > MAX_TILE_ZOOM)
+            return false;
+
+        const int tileCount = 1 << z;
+        return x >= 0 && x < tileCount && y >= 0 && y < tileCount;
+    }
+
+    TileBounds getTileBounds(const int z, const int x, const int y) {
+        // see: https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames [2026-10-19]
+        const double tileCount = 1 << z;
+        const auto latitude = [tileCount](const int tileY) {
+            return std::atan(std::sinh(std::numbers::pi * (1 - 2 * tileY / tileCount))) * 180 / std::numbers::pi;
+        };
+        const auto longitude = [tileCount](const int tileX) { return tileX / tileCount * 360 - 180; };
+
+        return TileBounds{latitude(y + 1), longitude(x), latitude(y), longitude(x + 1)};
+    }
+
+    bool tileOverlaps(const TileBounds &bounds, const std::vector<OSMPoint> &corners) {
+        if (corners.empty())
+            return false;
+
+        TileBounds box{corners[0].lat, corners[0].lng, corners[0].lat, corners[0].lng};
+        for (const auto [lat, lng]: corners) {
+            box.minLat = std::min(box.minLat, lat);
+            box.minLng = std::min(box.minLng, lng);
+            box.maxLat = std::max(box.maxLat, lat);
+            box.maxLng = std::max(box.maxLng, lng);
+        }
+
+        return box.minLat <= bounds.maxLat && box.maxLat >= bounds.minLat && box.minLng <= bounds.maxLng &&
+               box.maxLng >= bounds.minLng;
+    }
+
+    void computeHillshade(const std::vector<float> &heights, const int sizeX, const int sizeY, const float pixelSize,
+                          std::vector<uint8_t> &shade, std::vector<uint8_t> &alpha) {
+        shade.resize(static_cast<size_t>(sizeX) * sizeY);
+        alpha.resize(static_cast<size_t>(sizeX) * sizeY);
+
+        const float sinAltitude = std::sin(LIGHT_ALTITUDE);
+        const float lightEast = std::sin(LIGHT_AZIMUTH) * std::cos(LIGHT_ALTITUDE);
+        const float lightNorth = std::cos(LIGHT_AZIMUTH) * std::cos(LIGHT_ALTITUDE);
+        const float scale = 1.0f / (8.0f * pixelSize);
+
+        const int stride = sizeX + 2;
+        for (int y = 0; y < sizeY; ++y) {
+            const float *top = heights.data() + static_cast<size_t>(y) * stride;
+            const float *mid = top + stride;
+            const float *bottom = mid + stride;
+            uint8_t *shadeRow = shade.data() + static_cast<size_t>(y) * sizeX;
+            uint8_t *alphaRow = alpha.data() + static_cast<size_t>(y) * sizeX;
+
+            // branch free, so the compiler can vectorize the loop, NaN heights propagate into the light value
+            for (int x = 0; x < sizeX; ++x) {
+                const float east = top[x + 2] + 2 * mid[x + 2] + bottom[x + 2];
+                const float west = top[x] + 2 * mid[x] + bottom[x];
+                const float north = top[x] + 2 * top[x + 1] + top[x + 2];
+                const float south = bottom[x] + 2 * bottom[x + 1] + bottom[x + 2];
+                const float dzEast = (east - west) * scale;
+                const float dzNorth = (north - south) * scale;
+
+                // dot product between the surface normal and the direction of the light
+                const float light = (sinAltitude - dzEast * lightEast - dzNorth * lightNorth) /
+                                    std::sqrt(1.0f + dzEast * dzEast + dzNorth * dzNorth);
+                const float lit = light > 0.0f ? light : 0.0f; // also maps NaN to 0
+                shadeRow[x] = static_cast<uint8_t>(static_cast<int>(lit * 255.0f));
+                alphaRow[x] = light == light ? 255 : 0;
+            }
+        }
+    }
+
+    std::string renderHillshadeTile(const std::string &filePath, const ProjectionWrapper &srcProjRef, const int z,
+                                    const int x, const int y) {
+        const GDALDatasetWrapper dataset(filePath);
+        if (!dataset.IsValid())
+            return "";
+
+        // reads one extra pixel on each side, so the pixels at the edge of the tile have all their neighbours
+        constexpr int border = 1;
+        constexpr int size = TILE_SIZE + 2 * border;
+        const double resolution = MERCATOR_EXTEND / (TILE_SIZE * static_cast<double>(1 << z));
+        const GeoTransform transform{-MERCATOR_EXTEND / 2 + (x * TILE_SIZE - border) * resolution,
+                                     resolution,
+                                     0,
+                                     MERCATOR_EXTEND / 2 - (y * TILE_SIZE - border) * resolution,
+                                     0,
+                                     -resolution};
+
+        const auto heights = dataset.ReadWarped(srcProjRef, webMercatorProjRef, transform, size, size);
+        if (heights.empty())
+            return "";
+
+        // web mercator stretches distances by 1 / cos(latitude), using the center keeps the error small within a tile
+        const auto [minLat, minLng, maxLat, maxLng] = getTileBounds(z, x, y);
+        const double centerLatitude = (minLat + maxLat) / 2 * std::numbers::pi / 180;
+        const auto pixelSize = static_cast<float>(resolution * std::cos(centerLatitude));
+
+        std::vector<uint8_t> shade;
+        std::vector<uint8_t> alpha;
+        computeHillshade(heights, TILE_SIZE, TILE_SIZE, pixelSize, shade, alpha);
+
+        return encodePng(shade, alpha, TILE_SIZE, TILE_SIZE);
+    }
+
+} // namespace TrackMapper::Raster
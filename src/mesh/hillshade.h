@@ -0,0 +1,57 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef HILLSHADE_H
+#define HILLSHADE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gdal_wrapper.h"
+#include "raster_reader.h"
+
+namespace TrackMapper::Raster {
+
+    inline ProjectionWrapper webMercatorProjRef(
+            R"(PROJCS["WGS 84 / Pseudo-Mercator",GEOGCS["WGS 84",DATUM["WGS_1984",SPHEROID["WGS 84",6378137,298.257223563,AUTHORITY["EPSG","7030"]],AUTHORITY["EPSG","6326"]],PRIMEM["Greenwich",0,AUTHORITY["EPSG","8901"]],UNIT["degree",0.0174532925199433,AUTHORITY["EPSG","9122"]],AUTHORITY["EPSG","4326"]],PROJECTION["Mercator_1SP"],PARAMETER["central_meridian",0],PARAMETER["scale_factor",1],PARAMETER["false_easting",0],PARAMETER["false_northing",0],UNIT["metre",1,AUTHORITY["EPSG","9001"]],AXIS["Easting",EAST],AXIS["Northing",NORTH],EXTENSION["PROJ4","+proj=merc +a=6378137 +b=6378137 +lat_ts=0 +lon_0=0 +x_0=0 +y_0=0 +k=1 +units=m +nadgrids=@null +wktext +no_defs"],AUTHORITY["EPSG","3857"]])");
+
+    constexpr int TILE_SIZE = 256; // pixels per side of a tile
+    constexpr int MAX_TILE_ZOOM = 22;
+
+    /// Area covered by a xyz tile in osm coordinates
+    struct TileBounds {
+        double minLat, minLng, maxLat, maxLng;
+    };
+
+    /// @return whether the tile exists in the xyz tile scheme
+    bool isValidTile(int z, int x, int y);
+
+    TileBounds getTileBounds(int z, int x, int y);
+
+    /// @return whether the bounding box of the corners overlaps the tile
+    bool tileOverlaps(const TileBounds &bounds, const std::vector<OSMPoint> &corners);
+
+    /**
+     * Shades the heights with light from the north west at an altitude of 45°, like gdaldem hillshade
+     * @param heights (sizeX + 2) * (sizeY + 2) heights in row major order, the outer ring is only used as neighbours
+     * @param pixelSize Distance between neighbouring heights in the unit of the heights
+     * @param shade sizeX * sizeY brightness values
+     * @param alpha sizeX * sizeY values, transparent where a height or one of its neighbours is NaN
+     * @see [Horn's method](https://pro.arcgis.com/en/pro-app/latest/tool-reference/3d-analyst/how-hillshade-works.htm)
+     */
+    void computeHillshade(const std::vector<float> &heights, int sizeX, int sizeY, float pixelSize,
+                          std::vector<uint8_t> &shade, std::vector<uint8_t> &alpha);
+
+    /**
+     * Renders the hillshade of a raster for the xyz tile
+     * @param srcProjRef Projection of the raster, can differ from the one stored in the file
+     * @return bytes of the png image, empty if the raster could not be read
+     */
+    std::string renderHillshadeTile(const std::string &filePath, const ProjectionWrapper &srcProjRef, int z, int x,
+                                    int y);
+
+} // namespace TrackMapper::Raster
+
+#endif // HILLSHADE_H
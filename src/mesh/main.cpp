@@ -118,7 +118,7 @@ void createMesh() {
     end_time = std::chrono::steady_clock::now();
     std::cout << "..in " << std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count() << "ms"
               << std::endl;
-    std::cout << "Size: x: " << data.sizeX << " y: " << data.sizeY << " Points: " << data.points.size() << std::endl;
+    std::cout << "Size: x: " << data.sizeX << " y: " << data.sizeY << " Points: " << data.heights.Size() << std::endl;
 
 
     std::cout << "Creating mesh.." << std::endl;
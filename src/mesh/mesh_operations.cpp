@@ -17,29 +17,33 @@ namespace TrackMapper::Mesh {
 
     namespace SMS = CGAL::Surface_mesh_simplification;
 
-    CGALMesh meshFromRasterData(const Raster::PointGrid &point_grid) {
+    CGALMesh meshFromRasterData(const Raster::Heightfield &heightfield) {
         CGALMesh mesh;
+        const auto pointCount = static_cast<size_t>(heightfield.sizeX) * heightfield.sizeY;
         std::vector<CGALMesh::Vertex_index> vertex_indices;
-        vertex_indices.reserve(point_grid.points.size());
+        vertex_indices.reserve(pointCount);
 
-        const auto quads = (point_grid.sizeX - 1) * (point_grid.sizeY - 1);
-        mesh.reserve(point_grid.points.size(),
+        const auto quads = static_cast<size_t>(std::max(heightfield.sizeX - 1, 0)) * std::max(heightfield.sizeY - 1, 0);
+        mesh.reserve(pointCount,
                      // one triangle per quad + all the right most vertical edges + all the lowest horizontal edges
-                     quads * 3 + (point_grid.sizeX - 1) + (point_grid.sizeY - 1), quads * 2);
+                     quads * 3 + (heightfield.sizeX - 1) + (heightfield.sizeY - 1), quads * 2);
 
-        for (auto [x, y, z]: point_grid.points) {
-            const auto vertexIndex = mesh.add_vertex({x, y, z});
-            vertex_indices.push_back(vertexIndex);
+        // positions get computed from the indices, only the heights are stored in the heightfield
+        for (int z = 0; z < heightfield.sizeY; ++z) {
+            for (int x = 0; x < heightfield.sizeX; ++x) {
+                const auto [px, py, pz] = heightfield.GetPoint(x, z);
+                vertex_indices.push_back(mesh.add_vertex({px, py, pz}));
+            }
         }
 
-        for (int y = 0; y < point_grid.sizeY - 1; ++y) {
-            for (int x = 0; x < point_grid.sizeX - 1; ++x) {
+        for (int y = 0; y < heightfield.sizeY - 1; ++y) {
+            for (int x = 0; x < heightfield.sizeX - 1; ++x) {
                 // Note: points extend in positive x and positive z axis
                 // Note: needs to conform with the right handed coordinate system of fbx
-                const int indexTL = y * point_grid.sizeX + x;
-                const int indexTR = y * point_grid.sizeX + (x + 1);
-                const int indexBL = (y + 1) * point_grid.sizeX + x;
-                const int indexBR = (y + 1) * point_grid.sizeX + (x + 1);
+                const auto indexTL = heightfield.GetIndex(x, y);
+                const auto indexTR = heightfield.GetIndex(x + 1, y);
+                const auto indexBL = heightfield.GetIndex(x, y + 1);
+                const auto indexBR = heightfield.GetIndex(x + 1, y + 1);
                 mesh.add_face(vertex_indices[indexTL], vertex_indices[indexTR], vertex_indices[indexBL]);
                 mesh.add_face(vertex_indices[indexTR], vertex_indices[indexBR], vertex_indices[indexBL]);
             }
@@ -20,7 +20,7 @@ namespace TrackMapper::Mesh {
         std::vector<CGALPoint3> points;
     };
 
-    CGALMesh meshFromRasterData(const Raster::PointGrid &point_grid);
+    CGALMesh meshFromRasterData(const Raster::Heightfield &heightfield);
 
     CGALMesh meshFromPath(const Path &path, double width, int subdivisions);
 
@@ -0,0 +1,314 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "raster_cache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <string_view>
+
+namespace TrackMapper::Raster {
+    // index file format: one entry per line, fields separated by tabs
+    // M <path> <size> <mtime> <sizeX> <sizeY> <6 transform values> <projRef valid> <projRef wkt>
+    // E <path> <size> <mtime> <src wkt> <8 values for lat/lng of the 4 corners>
+    constexpr char INDEX_SEPARATOR = '\t';
+    constexpr int CORNER_COUNT = 4;
+    // the index gets rewritten once less than half of its lines are up to date, small ones are never worth it
+    constexpr size_t MIN_INDEX_LINES_TO_COMPACT = 256;
+
+    static bool getFileStamp(const std::string &filePath, uintmax_t &fileSize, int64_t &writeTime);
+    static std::string formatMetadataLine(const std::string &filePath, uintmax_t fileSize, int64_t writeTime,
+                                          const RasterMetadata &metadata);
+    static std::string formatExtendsLine(const std::string &filePath, uintmax_t fileSize, int64_t writeTime,
+                                         const std::string &srcWKT, const std::vector<OSMPoint> &extends);
+    static std::string sanitizeField(std::string_view field);
+    static std::vector<std::string_view> splitLine(std::string_view line);
+    static void appendField(std::string &line, std::string_view field);
+    static void appendNumber(std::string &line, auto value);
+    static bool parseNumber(std::string_view field, auto &value);
+
+    RasterMetadataCache::RasterMetadataCache(std::string indexFilePath) : mIndexFilePath(std::move(indexFilePath)) {
+        if (!mIndexFilePath.empty()) {
+            mLoadIndex();
+            mCompactIndex();
+        }
+    }
+
+    RasterMetadataCache::~RasterMetadataCache() {
+        if (!mIndexFilePath.empty()) {
+            const std::lock_guard lock(mMutex);
+            mCompactIndex();
+        }
+    }
+
+    std::optional<RasterMetadata> RasterMetadataCache::GetMetadata(const std::string &filePath) {
+        uintmax_t fileSize;
+        int64_t writeTime;
+        const bool cacheable = getFileStamp(filePath, fileSize, writeTime); // e.g. gdal virtual file systems are not
+        if (cacheable) {
+            const std::lock_guard lock(mMutex);
+            if (const auto entry = mFindEntry(filePath, fileSize, writeTime)) {
+                mHits.fetch_add(1, std::memory_order_relaxed);
+                return entry->metadata;
+            }
+        }
+        mMisses.fetch_add(1, std::memory_order_relaxed);
+
+        // opening the file is the expensive part, so it happens outside of the lock
+        const GDALDatasetWrapper dataset(filePath);
+        if (!dataset.IsValid())
+            return std::nullopt;
+
+        RasterMetadata metadata;
+        metadata.transform = dataset.GetGeoTransform();
+        metadata.sizeX = dataset.GetSizeX();
+        metadata.sizeY = dataset.GetSizeY();
+        metadata.projRef = dataset.GetProjectionRef().Get();
+        metadata.projRefValid = dataset.GetProjectionRef().IsValid();
+
+        if (!cacheable)
+            return metadata;
+
+        {
+            const std::lock_guard lock(mMutex);
+            mEntries[filePath] = Entry{fileSize, writeTime, metadata, {}};
+        }
+        mAppendToIndex(formatMetadataLine(filePath, fileSize, writeTime, metadata));
+
+        return metadata;
+    }
+
+    std::optional<std::vector<OSMPoint>> RasterMetadataCache::GetExtends(const std::string &filePath,
+                                                                         const ProjectionWrapper &srcProjRef) {
+        if (!srcProjRef.IsValid())
+            return std::nullopt;
+
+        const std::string srcWKT = sanitizeField(srcProjRef.Get());
+
+        uintmax_t fileSize;
+        int64_t writeTime;
+        const bool cacheable = getFileStamp(filePath, fileSize, writeTime);
+        if (cacheable) {
+            const std::lock_guard lock(mMutex);
+            if (const auto entry = mFindEntry(filePath, fileSize, writeTime)) {
+                if (const auto it = entry->extends.find(srcWKT); it != entry->extends.end()) {
+                    mHits.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+            }
+        }
+        mMisses.fetch_add(1, std::memory_order_relaxed);
+
+        const auto metadata = GetMetadata(filePath);
+        if (!metadata)
+            return std::nullopt;
+
+        auto extends = getDatasetExtends(metadata->transform, metadata->sizeX, metadata->sizeY);
+
+        {
+            const std::lock_guard lock(mMutex);
+            auto &transformer = mTransformers[srcWKT];
+            if (!transformer) {
+                transformer = std::make_unique<GDALReprojectionTransformer>(srcProjRef, osmPointsProjRef);
+            }
+            if (!transformer->IsValid())
+                return std::nullopt;
+            for (auto &[lat, lng]: extends) {
+                if (const bool success = transformer->Transform(&lat, &lng, nullptr); !success)
+                    return std::nullopt;
+            }
+
+            const auto entry = cacheable ? mFindEntry(filePath, fileSize, writeTime) : nullptr;
+            if (entry == nullptr)
+                return extends;
+
+            entry->extends[srcWKT] = extends;
+        }
+        mAppendToIndex(formatExtendsLine(filePath, fileSize, writeTime, srcWKT, extends));
+
+        return extends;
+    }
+
+    RasterMetadataCache::Entry *RasterMetadataCache::mFindEntry(const std::string &filePath, const uintmax_t fileSize,
+                                                                const int64_t writeTime) {
+        const auto it = mEntries.find(filePath);
+        if (it == mEntries.end() || it->second.fileSize != fileSize || it->second.writeTime != writeTime)
+            return nullptr;
+
+        return &it->second;
+    }
+
+    void RasterMetadataCache::mLoadIndex() {
+        std::ifstream index(mIndexFilePath);
+        std::string line;
+        while (std::getline(index, line)) {
+            ++mIndexLineCount;
+            const auto fields = splitLine(line);
+            if (fields.size() < 4)
+                continue; // skips lines broken by e.g. a crash while writing
+
+            const std::string filePath(fields[1]);
+            uintmax_t fileSize;
+            int64_t writeTime;
+            if (!parseNumber(fields[2], fileSize) || !parseNumber(fields[3], writeTime))
+                continue;
+
+            if (fields[0] == "M" && fields.size() == 14) {
+                Entry entry{fileSize, writeTime, {}, {}};
+                auto &metadata = entry.metadata;
+                int projRefValid;
+                bool valid = parseNumber(fields[4], metadata.sizeX) && parseNumber(fields[5], metadata.sizeY) &&
+                             parseNumber(fields[12], projRefValid);
+                for (size_t i = 0; i < metadata.transform.size(); ++i) {
+                    valid &= parseNumber(fields[6 + i], metadata.transform[i]);
+                }
+                metadata.projRefValid = projRefValid != 0;
+                metadata.projRef = fields[13];
+
+                // later lines are newer and replace earlier ones
+                if (valid) {
+                    mEntries[filePath] = std::move(entry);
+                }
+            } else if (fields[0] == "E" && fields.size() == 5 + 2 * CORNER_COUNT) {
+                const auto entry = mFindEntry(filePath, fileSize, writeTime);
+                if (entry == nullptr)
+                    continue;
+
+                std::vector<OSMPoint> extends(CORNER_COUNT);
+                bool valid = true;
+                for (int i = 0; i < CORNER_COUNT; ++i) {
+                    valid &= parseNumber(fields[5 + 2 * i], extends[i].lat);
+                    valid &= parseNumber(fields[6 + 2 * i], extends[i].lng);
+                }
+                if (valid) {
+                    entry->extends[std::string(fields[4])] = std::move(extends);
+                }
+            }
+        }
+    }
+
+    void RasterMetadataCache::mAppendToIndex(const std::string &line) {
+        if (mIndexFilePath.empty())
+            return;
+
+        // appending keeps writes small, outdated lines get replaced by later ones when loading
+        const std::lock_guard lock(mIndexMutex);
+        std::ofstream index(mIndexFilePath, std::ios::app);
+        index << line << '\n';
+        ++mIndexLineCount;
+    }
+
+    void RasterMetadataCache::mCompactIndex() {
+        size_t upToDateLineCount = 0;
+        for (const auto &entry: mEntries | std::views::values) {
+            upToDateLineCount += 1 + entry.extends.size();
+        }
+
+        const std::lock_guard lock(mIndexMutex);
+        if (mIndexLineCount < MIN_INDEX_LINES_TO_COMPACT || mIndexLineCount <= 2 * upToDateLineCount)
+            return;
+
+        // written next to the index and renamed over it, so a crash while writing keeps the old index intact
+        const std::string tempFilePath = mIndexFilePath + ".tmp";
+        {
+            std::ofstream index(tempFilePath, std::ios::trunc);
+            for (const auto &[filePath, entry]: mEntries) {
+                index << formatMetadataLine(filePath, entry.fileSize, entry.writeTime, entry.metadata) << '\n';
+                for (const auto &[srcWKT, extends]: entry.extends) {
+                    index << formatExtendsLine(filePath, entry.fileSize, entry.writeTime, srcWKT, extends) << '\n';
+                }
+            }
+            if (!index.flush())
+                return;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempFilePath, mIndexFilePath, ec);
+        if (ec) {
+            std::filesystem::remove(tempFilePath, ec);
+            return;
+        }
+        mIndexLineCount = upToDateLineCount;
+    }
+
+    static bool getFileStamp(const std::string &filePath, uintmax_t &fileSize, int64_t &writeTime) {
+        std::error_code ec;
+        fileSize = std::filesystem::file_size(filePath, ec);
+        if (ec)
+            return false;
+
+        writeTime = std::filesystem::last_write_time(filePath, ec).time_since_epoch().count();
+        return !ec;
+    }
+
+    static std::string formatMetadataLine(const std::string &filePath, const uintmax_t fileSize,
+                                          const int64_t writeTime, const RasterMetadata &metadata) {
+        std::string line = "M";
+        appendField(line, filePath);
+        appendNumber(line, fileSize);
+        appendNumber(line, writeTime);
+        appendNumber(line, metadata.sizeX);
+        appendNumber(line, metadata.sizeY);
+        for (const double value: metadata.transform) {
+            appendNumber(line, value);
+        }
+        appendNumber(line, metadata.projRefValid ? 1 : 0);
+        appendField(line, metadata.projRef);
+        return line;
+    }
+
+    static std::string formatExtendsLine(const std::string &filePath, const uintmax_t fileSize,
+                                         const int64_t writeTime, const std::string &srcWKT,
+                                         const std::vector<OSMPoint> &extends) {
+        std::string line = "E";
+        appendField(line, filePath);
+        appendNumber(line, fileSize);
+        appendNumber(line, writeTime);
+        appendField(line, srcWKT);
+        for (const auto [lat, lng]: extends) {
+            appendNumber(line, lat);
+            appendNumber(line, lng);
+        }
+        return line;
+    }
+
+    static std::string sanitizeField(const std::string_view field) {
+        // separators can only appear as whitespace in wkt strings, where any whitespace is equivalent
+        std::string sanitized(field);
+        std::ranges::replace(sanitized, INDEX_SEPARATOR, ' ');
+        std::ranges::replace(sanitized, '\n', ' ');
+        std::ranges::replace(sanitized, '\r', ' ');
+        return sanitized;
+    }
+
+    static std::vector<std::string_view> splitLine(const std::string_view line) {
+        std::vector<std::string_view> fields;
+        for (const auto field: std::views::split(line, INDEX_SEPARATOR)) {
+            fields.emplace_back(field.begin(), field.end());
+        }
+        return fields;
+    }
+
+    static void appendField(std::string &line, const std::string_view field) {
+        line.push_back(INDEX_SEPARATOR);
+        line.append(sanitizeField(field));
+    }
+
+    static void appendNumber(std::string &line, const auto value) {
+        // to_chars writes the shortest representation that reads back to the exact same value
+        char buffer[32];
+        const auto [end, _] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        line.push_back(INDEX_SEPARATOR);
+        line.append(buffer, end);
+    }
+
+    static bool parseNumber(const std::string_view field, auto &value) {
+        const auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+        return ec == std::errc() && ptr == field.data() + field.size();
+    }
+
+} // namespace TrackMapper::Raster
@@ -0,0 +1,90 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef RASTER_CACHE_H
+#define RASTER_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gdal_wrapper.h"
+#include "raster_reader.h"
+
+namespace TrackMapper::Raster {
+
+    /// Information about a raster that is available without reading its data
+    struct RasterMetadata {
+        GeoTransform transform{};
+        int sizeX = 0, sizeY = 0;
+        std::string projRef; // wkt of the projection stored in the file
+        bool projRefValid = false;
+    };
+
+    /// Caches the metadata and the extends of raster files, so repeated lookups don't have to open the files again
+    /// @note Entries are keyed by file path, size and modification time, a changed file gets read again
+    /// @note All methods are thread safe
+    class RasterMetadataCache {
+    public:
+        /**
+         * @param indexFilePath File to keep the cache in between runs, gets created if it does not exist.
+         * Leave empty to only keep the cache in memory.
+         */
+        explicit RasterMetadataCache(std::string indexFilePath = "");
+
+        /// Rewrites the index file without outdated lines if it has too many of them
+        ~RasterMetadataCache();
+
+        /// @return metadata of the raster or nullopt if the file could not be opened
+        [[nodiscard]] std::optional<RasterMetadata> GetMetadata(const std::string &filePath);
+
+        /**
+         * @param srcProjRef Projection of the raster, can differ from the one stored in the file
+         * @return corners of the raster in osm coordinates ordered like getDatasetExtends, nullopt if the file could
+         * not be opened or the reprojection failed
+         */
+        [[nodiscard]] std::optional<std::vector<OSMPoint>> GetExtends(const std::string &filePath,
+                                                                      const ProjectionWrapper &srcProjRef);
+
+        [[nodiscard]] uint64_t GetHitCount() const { return mHits.load(std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t GetMissCount() const { return mMisses.load(std::memory_order_relaxed); }
+
+    private:
+        struct Entry {
+            uintmax_t fileSize;
+            int64_t writeTime;
+            RasterMetadata metadata;
+            std::map<std::string, std::vector<OSMPoint>> extends; // keyed by wkt of the source projection
+        };
+
+        std::string mIndexFilePath;
+        std::mutex mIndexMutex; // serializes writes to the index file, locked after mMutex when both are needed
+        size_t mIndexLineCount = 0; // lines in the index file including outdated ones, guarded by mIndexMutex
+        std::mutex mMutex;
+        std::map<std::string, Entry> mEntries;
+        // creating transformers is expensive, most rasters of a folder share the same projection
+        std::map<std::string, std::unique_ptr<GDALReprojectionTransformer>> mTransformers;
+
+        std::atomic<uint64_t> mHits = 0;
+        std::atomic<uint64_t> mMisses = 0;
+
+        /// @return entry of the file if it is cached and up to date, expects the mutex to be locked
+        Entry *mFindEntry(const std::string &filePath, uintmax_t fileSize, int64_t writeTime);
+
+        void mLoadIndex();
+        /// Expects the mutex to not be locked, so lookups don't wait for the disk
+        void mAppendToIndex(const std::string &line);
+        /// Rewrites the index file from the cached entries if most of its lines are outdated, expects the mutex to be
+        /// locked
+        void mCompactIndex();
+    };
+
+} // namespace TrackMapper::Raster
+
+#endif // RASTER_CACHE_H
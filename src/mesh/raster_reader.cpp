@@ -5,19 +5,49 @@
 #include "raster_reader.h"
 #include "gdal_wrapper.h"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <variant>
 
 namespace TrackMapper::Raster {
+    // pixels per window, big enough to make the reads efficient, 4MB for byte up to 32MB for float64 bands
+    constexpr int64_t RASTER_WINDOW_PIXELS = 1 << 22;
+
     Point::Point(const double x, const double y, const double z) : x(x), y(y), z(z) {}
 
-    PointGrid readRasterData(GDALDatasetWrapper &dataset) {
-        const GeoTransform &transform = dataset.GetGeoTransform();
+    Point Heightfield::GetPoint(const int x, const int z) const {
+        // rows start at the origin, which is the last row of the raster for flipped rasters
+        const bool flippedZOrigin = transform[5] < 0;
+        const int rasterY = flippedZOrigin ? sizeY - 1 - z : z;
+        auto p = getRasterPoint(transform, x, rasterY) - getRasterPoint(transform, 0, flippedZOrigin ? sizeY - 1 : 0);
+        p.y = GetHeight(x, z);
+        return p;
+    }
+
+    Heightfield readRasterData(GDALDatasetWrapper &dataset, const int64_t maxPoints) {
         // Todo: handle rotated or skewed raster images (transform[2] and transform[4] are non zero)
 
-        PointGrid grid;
+        Heightfield grid;
         grid.sizeX = dataset.GetSizeX();
         grid.sizeY = dataset.GetSizeY();
+
+        // decimated grids cover the same area with bigger pixels
+        GeoTransform transform = dataset.GetGeoTransform();
+        if (maxPoints > 0 && dataset.GetPixelCount() > maxPoints) {
+            const double factor = std::sqrt(static_cast<double>(dataset.GetPixelCount()) / maxPoints);
+            const int sizeX = std::max(2, static_cast<int>(grid.sizeX / factor));
+            const int sizeY = std::max(2, static_cast<int>(grid.sizeY / factor));
+            const double scaleX = static_cast<double>(grid.sizeX) / sizeX;
+            const double scaleY = static_cast<double>(grid.sizeY) / sizeY;
+            transform[1] *= scaleX;
+            transform[4] *= scaleX;
+            transform[2] *= scaleY;
+            transform[5] *= scaleY;
+            grid.sizeX = sizeX;
+            grid.sizeY = sizeY;
+        }
+
         grid.pixelSizeX = transform[1];
         grid.pixelSizeY = transform[5];
 
@@ -34,43 +64,82 @@ namespace TrackMapper::Raster {
         grid.projRef = dataset.GetProjectionRef();
         grid.transform = transform;
 
-        const std::vector<float> &values = dataset.GetData();
-        grid.points.reserve(values.size());
-
-        if (flippedZOrigin) {
-            const auto refPoint = getRasterPoint(transform, 0, grid.sizeY - 1);
-            for (int z = 0; z < dataset.GetSizeY(); ++z) {
-                for (int x = 0; x < dataset.GetSizeX(); ++x) {
-                    const auto coordZ = dataset.GetSizeY() - 1 - z;
-                    auto p = getRasterPoint(transform, x, coordZ) - refPoint;
-                    const auto height = values[grid.GetIndex(x, coordZ)];
-                    p.y = height;
-                    grid.points.push_back(p);
-                }
-            }
-        } else {
-            const auto refPoint = getRasterPoint(transform, 0, 0);
-            for (int z = 0; z < dataset.GetSizeY(); ++z) {
-                for (int x = 0; x < dataset.GetSizeX(); ++x) {
-                    auto p = getRasterPoint(transform, x, z) - refPoint;
-                    const auto height = values[grid.GetIndex(x, z)];
-                    p.y = height;
-                    grid.points.push_back(p);
-                }
-            }
+        // rows of the heightfield start at its origin, which is the last row of the raster for flipped rasters
+        const bool success = forEachRasterWindow(dataset, grid.sizeX, grid.sizeY, [&](const RasterWindow &window) {
+            // visiting once per window copies whole rows in the data type of the file
+            std::visit(
+                    [&](const auto &values) {
+                        using Values = std::decay_t<decltype(values)>;
+                        const size_t pointCount = static_cast<size_t>(grid.sizeX) * grid.sizeY;
+                        if (!std::holds_alternative<Values>(grid.heights.values) || grid.heights.Size() != pointCount) {
+                            grid.heights.values = Values(pointCount);
+                            grid.heights.encoding = window.buffer.encoding;
+                        }
+                        auto &heights = std::get<Values>(grid.heights.values);
+                        for (int row = 0; row < window.sizeY; ++row) {
+                            const int rasterY = window.offsetY + row;
+                            const int z = flippedZOrigin ? grid.sizeY - 1 - rasterY : rasterY;
+                            const auto first = values.begin() + static_cast<ptrdiff_t>(window.GetIndex(0, row));
+                            std::copy(first, first + grid.sizeX,
+                                      heights.begin() + static_cast<ptrdiff_t>(grid.GetIndex(0, z)));
+                        }
+                    },
+                    window.buffer.values);
+            return true;
+        });
+
+        if (!success) {
+            // an empty heightfield results in an empty mesh instead of a terrain with holes at height 0
+            grid.heights.values = std::vector<float>();
+            grid.sizeX = 0;
+            grid.sizeY = 0;
         }
 
         return grid;
     }
 
+    bool forEachRasterWindow(const GDALDatasetWrapper &dataset, const int sizeX, const int sizeY,
+                             const std::function<bool(const RasterWindow &)> &onWindow) {
+        const int datasetSizeX = dataset.GetSizeX();
+        const int datasetSizeY = dataset.GetSizeY();
+        if (datasetSizeX <= 0 || datasetSizeY <= 0 || sizeX <= 0 || sizeY <= 0)
+            return dataset.IsValid();
+
+        // whole rows of blocks, as many as fit into the window size but at least one
+        const int blockSizeY = std::max(1, dataset.GetBlockSize().second);
+        const int64_t blockRowsPerWindow = std::max<int64_t>(1, RASTER_WINDOW_PIXELS / datasetSizeX / blockSizeY);
+        const int64_t datasetRowsPerWindow = std::min<int64_t>(blockRowsPerWindow * blockSizeY, datasetSizeY);
+
+        // decimated reads cover more rows of the dataset per row of the window
+        const double scaleY = static_cast<double>(datasetSizeY) / sizeY;
+        const int rowsPerWindow = std::max(1, static_cast<int>(static_cast<double>(datasetRowsPerWindow) / scaleY));
+
+        RasterWindow window{0, sizeX, 0, {}}; // reuses the memory of the values between windows
+        for (int offsetY = 0; offsetY < sizeY; offsetY += rowsPerWindow) {
+            window.offsetY = offsetY;
+            window.sizeY = std::min(rowsPerWindow, sizeY - offsetY);
+
+            // the last window ends exactly at the last row, independent of rounding errors
+            const double datasetOffsetY = offsetY * scaleY;
+            const int endY = offsetY + window.sizeY;
+            const double datasetEndY = endY == sizeY ? datasetSizeY : endY * scaleY;
+            if (!dataset.ReadWindow(0, datasetOffsetY, datasetSizeX, datasetEndY - datasetOffsetY, sizeX, window.sizeY,
+                                    window.buffer))
+                return false;
+            if (!onWindow(window))
+                break;
+        }
+        return true;
+    }
+
     std::vector<OSMPoint> getDatasetExtends(const GDALDatasetWrapper &dataset) {
+        return getDatasetExtends(dataset.GetGeoTransform(), dataset.GetSizeX(), dataset.GetSizeY());
+    }
+
+    std::vector<OSMPoint> getDatasetExtends(const GeoTransform &transform, const int sizeX, const int sizeY) {
         // NOTE: this function does NOT conform with the inverted z coordinate system of fbx scenes
 
         // see: https://gdal.org/en/latest/tutorials/geotransforms_tut.html [2024-09-11]
-        const GeoTransform &transform = dataset.GetGeoTransform();
-        const int sizeX = dataset.GetSizeX();
-        const int sizeY = dataset.GetSizeY();
-
         std::vector<OSMPoint> extends;
         auto p = getRasterPoint(transform, 0, 0, true);
         extends.emplace_back(p.x, p.z); // (0, 0)
@@ -101,29 +170,69 @@ namespace TrackMapper::Raster {
 
         const GDALReprojectionTransformer transformer(srcProjRef, dstProjRef);
 
-        for (auto &[lat, lng]: points) {
-            if (const bool success = transformer.Transform(&lat, &lng, nullptr); !success)
+        // transforming all points with one call avoids the per call overhead of gdal and proj
+        std::vector<double> x(points.size()), y(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            x[i] = points[i].lat;
+            y[i] = points[i].lng;
+        }
+        if (!transformer.TransformPoints(x, y))
+            return false;
+
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (std::isnan(x[i]))
                 return false;
+            points[i] = {x[i], y[i]};
         }
 
         return true;
     }
 
-    void SetHeightFromGrid(const PointGrid &grid, Point &point) { point.y = GetHeightForPointInGrid(grid, point); }
+    bool sampleRasterHeights(const GDALDatasetWrapper &dataset, const ProjectionWrapper &srcProjRef,
+                             const std::vector<OSMPoint> &points, std::vector<float> &heights) {
+        if (!srcProjRef.IsValid())
+            return false;
+
+        std::vector<size_t> missing;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (std::isnan(heights[i])) {
+                missing.push_back(i);
+            }
+        }
+        if (missing.empty())
+            return true;
+
+        std::vector<double> x(missing.size()), y(missing.size());
+        for (size_t i = 0; i < missing.size(); ++i) {
+            x[i] = points[missing[i]].lat;
+            y[i] = points[missing[i]].lng;
+        }
+        const GDALReprojectionTransformer transformer(osmPointsProjRef, srcProjRef);
+        if (!transformer.TransformPoints(x, y))
+            return false;
+
+        const auto sampled = dataset.SampleBilinear(x, y);
+        for (size_t i = 0; i < missing.size(); ++i) {
+            heights[missing[i]] = sampled[i];
+        }
+        return true;
+    }
+
+    void SetHeightFromGrid(const Heightfield &grid, Point &point) { point.y = GetHeightForPointInGrid(grid, point); }
 
-    double GetHeightForPointInGrid(const PointGrid &grid, const Point &point) {
+    double GetHeightForPointInGrid(const Heightfield &grid, const Point &point) {
         // TODO: this can only handle north aligned transforms - not transforms with rotation or shearing
         const int xIndex = std::floor(point.x / grid.pixelSizeX);
         const int yIndex = std::floor(point.z / grid.pixelSizeY);
 
-        const int index = grid.GetIndex(xIndex, yIndex);
+        const auto index = grid.GetIndex(xIndex, yIndex);
 
-        if (index >= grid.points.size()) {
+        if (index >= grid.heights.Size()) {
             // Todo: better handle edge cases
             return 0;
         }
 
-        return grid.points[index].y;
+        return grid.GetHeight(xIndex, yIndex);
     }
 
     Point getRasterPoint(const GeoTransform &transform, const int pixelX, const int pixelY, const bool raw) {
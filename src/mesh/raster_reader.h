@@ -5,6 +5,7 @@
 #ifndef RASTER_READER_H
 #define RASTER_READER_H
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -47,30 +48,79 @@ namespace TrackMapper::Raster {
         return Point{point.x * factor, point.y * factor, point.z * factor};
     }
 
-    struct PointGrid {
+    /// Heights of a raster on a regular grid, the position of each point follows from its index and the transform
+    /// @note Takes the memory of the heights in the data type of the file only, instead of a full point per pixel
+    struct Heightfield {
         // only supports non roateted/skewed rasters
-        std::vector<Point> points;
-        int sizeX, sizeY;
-        double pixelSizeX, pixelSizeY;
-        Point origin;
+        RasterBuffer heights; // row major, rows start at the origin
+        int sizeX = 0, sizeY = 0;
+        double pixelSizeX = 0, pixelSizeY = 0; // both positive
+        Point origin; // bottom left corner of the raster
         ProjectionWrapper projRef;
         GeoTransform transform;
 
-        [[nodiscard]] int GetIndex(const int x, const int y) const { return y * sizeX + x; }
+        [[nodiscard]] size_t GetIndex(const int x, const int z) const { return static_cast<size_t>(z) * sizeX + x; }
+
+        /// @return height of the point, 0 for pixels without data since holes would break the mesh simplification
+        [[nodiscard]] double GetHeight(const int x, const int z) const {
+            const float height = heights.GetHeight(GetIndex(x, z));
+            return std::isnan(height) ? 0 : height;
+        }
+
+        /// @return position of the point relative to the first point of the raster, with z mirrored for fbx scenes
+        [[nodiscard]] Point GetPoint(int x, int z) const;
+    };
+
+    /// Rows of the first raster band of a dataset, read in one piece
+    struct RasterWindow {
+        int offsetY, sizeX, sizeY; // in pixels of the read resolution, always spans the full width
+        RasterBuffer buffer; // row major, sizeX * sizeY values in the data type of the file
+
+        [[nodiscard]] size_t GetIndex(const int x, const int y) const { return static_cast<size_t>(y) * sizeX + x; }
     };
 
-    PointGrid readRasterData(GDALDatasetWrapper &dataset);
+    /**
+     * Streams the first raster band of the dataset in windows of whole rows from top to bottom
+     * @param sizeX,sizeY resolution the raster gets read at, the size of the dataset reads it at full resolution
+     * @param onWindow gets called for every window, reading stops early if it returns false
+     * @return false if reading a window failed
+     * @note The windows span whole blocks of the file and only one of them is held in memory at a time, so big rasters
+     * can be processed without ever loading them completely
+     */
+    bool forEachRasterWindow(const GDALDatasetWrapper &dataset, int sizeX, int sizeY,
+                             const std::function<bool(const RasterWindow &)> &onWindow);
+
+    /**
+     * @param maxPoints decimates the raster so the heightfield has at most about this many points, 0 reads it at full
+     * resolution
+     * @note Streams the raster, so besides the returned heightfield only a small window of the raster is held in memory
+     * @note Decimated heightfields get read from the overviews of the dataset if it has some, so reading them only
+     * takes as long as their size requires
+     */
+    Heightfield readRasterData(GDALDatasetWrapper &dataset, int64_t maxPoints = 0);
 
     std::vector<OSMPoint> getDatasetExtends(const GDALDatasetWrapper &dataset);
 
+    std::vector<OSMPoint> getDatasetExtends(const GeoTransform &transform, int sizeX, int sizeY);
+
     bool reprojectOSMPoints(std::vector<OSMPoint> &points, const ProjectionWrapper &dstProjRef);
 
     bool reprojectPoints(std::vector<OSMPoint> &points, const ProjectionWrapper &srcProjRef,
                          const ProjectionWrapper &dstProjRef);
 
-    void SetHeightFromGrid(const PointGrid &grid, Point &point);
+    /**
+     * Fills the heights of the points that are still NaN from the dataset, so overlapping rasters don't overwrite
+     * each other
+     * @param srcProjRef Projection of the dataset, can differ from the one stored in the file
+     * @param heights One value per point, points outside the dataset stay NaN
+     * @return false if the points could not be projected
+     */
+    bool sampleRasterHeights(const GDALDatasetWrapper &dataset, const ProjectionWrapper &srcProjRef,
+                             const std::vector<OSMPoint> &points, std::vector<float> &heights);
+
+    void SetHeightFromGrid(const Heightfield &grid, Point &point);
 
-    double GetHeightForPointInGrid(const PointGrid &grid, const Point &point);
+    double GetHeightForPointInGrid(const Heightfield &grid, const Point &point);
 
     Point getRasterPoint(const GeoTransform &transform, int pixelX, int pixelY, bool raw = false);
 
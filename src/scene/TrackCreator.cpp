@@ -17,19 +17,19 @@
 
 using ProjectionWrapper = TrackMapper::Raster::ProjectionWrapper;
 using TrackScene = TrackMapper::Scene::TrackScene;
-using PointGrid = TrackMapper::Raster::PointGrid;
+using Heightfield = TrackMapper::Raster::Heightfield;
 using OSMPoint = TrackMapper::Raster::OSMPoint;
 using Point3D = TrackMapper::Raster::Point;
 
 namespace TrackMapper::Scene {
-    void set_height_for_point(const Raster::PointGrid &grid, Point3D &point);
-    bool is_point_in_grid(const Raster::PointGrid &grid, const Point3D &point);
+    void set_height_for_point(const Raster::Heightfield &grid, Point3D &point);
+    bool is_point_in_grid(const Raster::Heightfield &grid, const Point3D &point);
 
     double lerp(const double a, const double b, const double t) { return a + (b - a) * t; }
 
     TrackCreator::TrackCreator(std::string name) : mName(std::move(name)), pLastGrid(nullptr) {}
 
-    void TrackCreator::AddRaster(const std::string &filePath) {
+    void TrackCreator::AddRaster(const std::string &filePath, const int64_t maxPoints) {
         // opening dataset
         TrackMapper::Raster::GDALDatasetWrapper dataset(filePath);
         if (!dataset.IsValid()) {
@@ -38,12 +38,12 @@ namespace TrackMapper::Scene {
                       << std::endl;
             return;
         }
-        const auto pointGrid = TrackMapper::Raster::readRasterData(dataset);
+        auto heightfield = TrackMapper::Raster::readRasterData(dataset, maxPoints);
 
         // TODO: Add tile slicing for resolution control and performance
 
         // creating mesh
-        auto mesh = TrackMapper::Mesh::meshFromRasterData(pointGrid);
+        auto mesh = TrackMapper::Mesh::meshFromRasterData(heightfield);
 
         // simplifying mesh
         const double reductionRation = std::min(40e3 / mesh.number_of_vertices(), 0.5);
@@ -51,18 +51,18 @@ namespace TrackMapper::Scene {
 
         // adding mesh to scene
         if (!mOriginSet) {
-            mOrigin = pointGrid.origin;
+            mOrigin = heightfield.origin;
             mOriginSet = true;
         }
 
-        const auto [x, y, z] = pointGrid.origin - mOrigin;
+        const auto [x, y, z] = heightfield.origin - mOrigin;
         auto sceneMesh = TrackMapper::Mesh::cgalToSceneMesh(mesh, {x, y, z}, [&mesh](const int i) -> Scene::Double2 {
             const auto point = mesh.point(static_cast<CGAL::SM_Vertex_index>(i));
             return {point.x(), point.z()}; // projects texture from above with one full texture per square meter
         });
 
         mScene.AddGrassMesh(sceneMesh);
-        mGrids.push_back(pointGrid);
+        mGrids.push_back(std::move(heightfield));
     }
 
 
@@ -275,12 +275,12 @@ namespace TrackMapper::Scene {
         }
     }
 
-    void set_height_for_point(const Raster::PointGrid &grid, Point3D &point) {
+    void set_height_for_point(const Raster::Heightfield &grid, Point3D &point) {
         const auto offsetIntoRaster = point - grid.origin;
         point.y = Raster::GetHeightForPointInGrid(grid, offsetIntoRaster);
     }
 
-    bool is_point_in_grid(const Raster::PointGrid &grid, const Point3D &point) {
+    bool is_point_in_grid(const Raster::Heightfield &grid, const Point3D &point) {
         // offset to near corner
         // ReSharper disable once CppTooWideScopeInitStatement
         auto [offsetX, offsetY, offsetZ] = point - grid.origin;
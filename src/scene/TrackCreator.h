@@ -22,7 +22,13 @@ namespace TrackMapper::Scene {
     public:
         explicit TrackCreator(std::string name);
 
-        void AddRaster(const std::string &filePath);
+        /**
+         * @param maxPoints reads the raster decimated to at most about this many points if it is bigger, 0 reads it at
+         * full resolution
+         * @note The terrain mesh gets simplified to a fixed vertex count anyway, while the heights of the roads are
+         * sampled from the read points, so the budget trades road height detail for reading and meshing time
+         */
+        void AddRaster(const std::string &filePath, int64_t maxPoints = 0);
 
         /// @note Make sure to first add all rasters so the path can get the correct height data
         void AddRoad(std::vector<Raster::OSMPoint> &points, const Raster::ProjectionWrapper &projRef, double width);
@@ -36,10 +42,10 @@ namespace TrackMapper::Scene {
     private:
         std::string mName;
         TrackScene mScene;
-        std::vector<Raster::PointGrid> mGrids; // needed for path height data
+        std::vector<Raster::Heightfield> mGrids; // needed for path height data
         Raster::Point mOrigin{}; // overall 3D reference point
         bool mOriginSet = false;
-        Raster::PointGrid *pLastGrid; // caches last grid for faster height finding
+        Raster::Heightfield *pLastGrid; // caches last grid for faster height finding
 
         void mAddRoad(const Mesh::Path &path, double width);
         void mInterpolateHeightForPoint(Raster::Point &point);
@@ -4,114 +4,542 @@
 
 #include "BasicWebApp.h"
 
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <ranges>
+#include <thread>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 #include "crow.h"
 
 #include "../graph/DijkstraPathfinding.h"
-#include "../graph/FMIGraphReader.h"
-#include "../graph/SimpleWorldGrid.h"
+#include "../graph/GraphReader.h"
+#include "../graph/HugePageArray.h"
+#include "../graph/SphericalKDTree.h"
 #include "../mesh/gdal_wrapper.h"
+#include "../mesh/hillshade.h"
+#include "../mesh/raster_cache.h"
 #include "../mesh/raster_reader.h"
 
+#include "ElevationProfile.h"
+#include "Histogram.h"
+#include "JsonWriter.h"
+#include "Metrics.h"
+#include "Polyline.h"
+#include "RoadTileIndex.h"
+#include "RouteCache.h"
+#include "TileCache.h"
 #include "errors.h"
 
 namespace TrackMapper::Web {
+    // limits of the spatial queries to keep responses of a single request small
+    constexpr int MAX_NEAREST_NODES = 1000;
+    constexpr double MAX_NODE_RADIUS = 5000; // meters
+    constexpr size_t MAX_REQUEST_BODY_SIZE = 1 << 20; // bytes, fits tracks with many thousand waypoints
+    constexpr auto STATIC_FILE_DIRECTORY = "static/"; // same as crows default, relative to the working directory
+    constexpr auto RASTER_INDEX_FILE = "raster_index.tsv"; // keeps the raster metadata cache between runs
+    constexpr auto TILE_CACHE_DIRECTORY = "tile_cache/"; // keeps rendered tiles between runs
+    constexpr size_t MAX_TILE_CACHE_MEMORY = 64 << 20; // bytes, about 1000 hillshade tiles
+    constexpr size_t MAX_TILE_CACHE_DISK = size_t{1} << 30; // bytes, tiles of changed rasters get evicted over time
+    constexpr size_t MAX_ROAD_TILE_CACHE_MEMORY = 128 << 20; // bytes, tiles of dense cities can reach a megabyte
+    constexpr int PRECOMPUTED_ROAD_TILES = 64; // tiles with the most roads, rendering them takes the longest
+    constexpr size_t MAX_CACHED_ROUTE_NODES = 1 << 22; // about 16 MiB of node ids
+    // upper estimates of the json size per node of a path, so the response buffer gets allocated only once
+    constexpr size_t PATH_NODE_BYTES = 64;
+    constexpr size_t PATH_POLYLINE_BYTES = 20; // up to 8 polyline chars plus the node id
+
+    /// Rejects requests with too big bodies before any route handler starts parsing them
+    /// @note Crow has already read the whole body into memory when this runs, so it bounds the parsing work of the
+    /// handlers but can't stop big uploads from being received
+    struct RequestBodyLimit {
+        struct context {};
+
+        void before_handle(const crow::request &req, crow::response &res, context &) const {
+            // checks the announced size first, the actual size catches chunked and mislabeled bodies
+            const auto &contentLength = req.get_header_value("Content-Length");
+            size_t announcedSize = 0;
+            const auto [_, ec] = std::from_chars(contentLength.data(), contentLength.data() + contentLength.size(),
+                                                 announcedSize);
+            if (ec != std::errc::result_out_of_range && announcedSize <= MAX_REQUEST_BODY_SIZE &&
+                req.body.size() <= MAX_REQUEST_BODY_SIZE)
+                return;
+
+            crow::json::wvalue x;
+            x["error"] = std::vformat(ERROR_BODY_TOO_LARGE, std::make_format_args(MAX_REQUEST_BODY_SIZE));
+            res.code = 413;
+            res.set_header("Content-Type", "application/json");
+            res.end(x.dump());
+        }
+
+        void after_handle(const crow::request &, crow::response &, context &) const {}
+    };
+
+    /// Records count, latency and status of every request
+    struct RequestMetrics {
+        struct context {
+            std::chrono::steady_clock::time_point startTime;
+        };
+
+        Metrics *pMetrics = nullptr; // set when the web app starts
+
+        void before_handle(const crow::request &, crow::response &, context &ctx) const {
+            ctx.startTime = std::chrono::steady_clock::now();
+        }
+
+        void after_handle(const crow::request &req, crow::response &res, const context &ctx) const {
+            if (pMetrics == nullptr)
+                return;
+
+            const auto latency = std::chrono::steady_clock::now() - ctx.startTime;
+            pMetrics->RecordRequest(Metrics::FindRoute(req.url),
+                                    std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), res.code);
+            if (!req.get_header_value("If-None-Match").empty()) {
+                pMetrics->etagCache.Record(res.code == 304);
+            }
+        }
+    };
+
+    /// Aggregated counters of all path queries done by the web app
+    struct SearchStatsHistograms {
+        Histogram settledNodes;
+        Histogram relaxedEdges;
+        Histogram heapPushes;
+        Histogram heapPops;
+        Histogram resetTimeUs;
+        Histogram totalTimeUs;
+
+        void Record(const SearchStats &stats) {
+            settledNodes.Record(stats.settledNodes);
+            relaxedEdges.Record(stats.relaxedEdges);
+            heapPushes.Record(stats.heapPushes);
+            heapPops.Record(stats.heapPops);
+            resetTimeUs.Record(std::chrono::duration_cast<std::chrono::microseconds>(stats.resetTime).count());
+            totalTimeUs.Record(std::chrono::duration_cast<std::chrono::microseconds>(stats.totalTime).count());
+        }
+    };
+
+    crow::json::wvalue progress_event_to_json(const ProgressEvent &event);
+    std::string get_file_version(const std::string &filePath);
+    std::shared_ptr<const Path> get_route(RouteCache &routeCache, const DijkstraPathfinding &pathfinding,
+                                          SearchStatsHistograms &searchStats, const std::string &graphVersion,
+                                          int startNodeIndex, int targetNodeIndex);
+    std::string get_road_tile_key(const std::string &graphVersion, int z, int x, int y);
+
+    /// Raster that can be rendered as tiles, gets added when the extends of the raster are requested
+    struct TileRaster {
+        std::string filePath;
+        Raster::ProjectionWrapper projRef;
+        std::vector<Raster::OSMPoint> extends;
+    };
+
+    /// Graph and everything built from it, gets replaced as a whole when another graph is loaded
+    /// @note Requests hold on to the snapshot they started with, so a reload never frees data that is still in use
+    struct GraphSnapshot {
+        BasicGraph graph;
+        std::string version; // changes whenever the graph file changes, used as ETag of graph based responses
+        SphericalKDTree grid;
+        RoadTileIndex roadTiles;
+        DijkstraPathfinding pathfinding;
+
+        explicit GraphSnapshot(const std::string &filePath) :
+            graph{GraphReader::read(filePath)}, version{get_file_version(filePath)}, grid{graph}, roadTiles{graph},
+            pathfinding{graph} {}
+    };
+
+    std::string read_track_json(const crow::json::rvalue &trackJson, const GraphSnapshot &graph, TrackData &data);
+
     struct BasicWebApp::impl {
-        BasicGraph mGraph;
-        SimpleWorldGrid mGrid;
-        DijkstraPathfinding mPathfinding;
+        // readers load the pointer once per request, a reload stores a new snapshot and the old one gets freed when
+        // its last reader is done with it
+        std::atomic<std::shared_ptr<const GraphSnapshot>> mGraph;
+        RouteCache mRouteCache{MAX_CACHED_ROUTE_NODES};
+        SearchStatsHistograms mSearchStats;
+        Metrics mMetrics;
+        Raster::RasterMetadataCache mRasterCache{RASTER_INDEX_FILE};
+        TileCache mTileCache{TILE_CACHE_DIRECTORY, MAX_TILE_CACHE_MEMORY, MAX_TILE_CACHE_DISK};
+        TileCache mRoadTileCache{"", MAX_ROAD_TILE_CACHE_MEMORY, 0}; // road tiles are fast to render, no need for disk
+
+        std::mutex mTileRasterMutex;
+        std::vector<TileRaster> mTileRasters; // guarded by mTileRasterMutex, the index is the id used in tile urls
+
+        /// @return id of the raster, the same raster always gets the same id
+        int AddTileRaster(TileRaster raster) {
+            const std::lock_guard lock(mTileRasterMutex);
+            for (int i = 0; i < mTileRasters.size(); ++i) {
+                if (mTileRasters[i].filePath == raster.filePath &&
+                    mTileRasters[i].projRef.Get() == raster.projRef.Get()) {
+                    mTileRasters[i] = std::move(raster); // the file might have changed since
+                    return i;
+                }
+            }
+            mTileRasters.push_back(std::move(raster));
+            return static_cast<int>(mTileRasters.size()) - 1;
+        }
+
+        std::optional<TileRaster> GetTileRaster(const int id) {
+            const std::lock_guard lock(mTileRasterMutex);
+            if (id < 0 || id >= mTileRasters.size())
+                return std::nullopt;
+            return mTileRasters[id];
+        }
 
-        crow::SimpleApp app;
+        [[nodiscard]] std::shared_ptr<const GraphSnapshot> GetGraph() const { return mGraph.load(); }
+
+        /// Appends the locations of the nodes of the shortest path between the nodes, without the start node
+        void AppendRoute(const GraphSnapshot &graph, std::vector<Raster::OSMPoint> &path, const int startNodeIndex,
+                         const int targetNodeIndex) {
+            const auto route = get_route(mRouteCache, graph.pathfinding, mSearchStats, graph.version, startNodeIndex,
+                                         targetNodeIndex);
+            // skip first node to not add it twice from the previous segment
+            for (int i = 1; i < route->nodeIds.size(); ++i) {
+                const auto [lat, lng] = graph.graph.GetLocation(route->nodeIds[i]);
+                path.emplace_back(lat, lng);
+            }
+        }
+
+        /// Renders the tiles with the most roads in the background, so they are cached before the first user zooms in
+        /// @note Stops the rendering for the previous graph first
+        void PrecomputeRoadTiles(std::shared_ptr<const GraphSnapshot> graph) {
+            const std::lock_guard lock(mRoadTilePrecomputerMutex);
+            roadTilePrecomputer = std::jthread([this, graph = std::move(graph)](const std::stop_token &stopToken) {
+                for (const auto [x, y]: graph->roadTiles.GetMinZoomTiles() | std::views::take(PRECOMPUTED_ROAD_TILES)) {
+                    if (stopToken.stop_requested())
+                        return;
+                    constexpr int z = RoadTileIndex::MIN_ZOOM;
+                    const auto key = get_road_tile_key(graph->version, z, x, y);
+                    mRoadTileCache.Put(key, graph->roadTiles.RenderTile(z, x, y));
+                }
+            });
+        }
+
+        std::mutex mReloadMutex;
+        bool mReloading = false; // guarded by mReloadMutex
+        std::string mReloadError; // guarded by mReloadMutex, error of the last reload
+
+        /// Loads the graph in the background and swaps it in once it is ready
+        /// @return false if another graph is still being loaded
+        bool StartGraphReload(const std::string &filePath) {
+            const std::lock_guard lock(mReloadMutex);
+            if (mReloading)
+                return false;
+            mReloading = true;
+
+            // the previous loader already finished, assigning joins it
+            graphLoader = std::jthread([this, filePath] {
+                std::string error;
+                try {
+                    auto graph = std::make_shared<const GraphSnapshot>(filePath);
+                    std::cout << "Loaded graph " << filePath << " with " << graph->graph.GetNodeCount() << " nodes"
+                              << std::endl;
+                    mGraph.store(graph);
+                    mMetrics.graphReloads.fetch_add(1, std::memory_order_relaxed);
+                    PrecomputeRoadTiles(std::move(graph));
+                } catch (const std::exception &e) {
+                    error = e.what();
+                } catch (...) {
+                    error = "unknown error";
+                }
+
+                const std::lock_guard reloadLock(mReloadMutex);
+                mReloading = false;
+                mReloadError = std::move(error);
+            });
+            return true;
+        }
+
+        std::mutex mProgressMutex;
+        // connections that subscribed to the progress of a job, by job id, guarded by mProgressMutex
+        std::unordered_map<int, std::unordered_set<crow::websocket::connection *>> mProgressSubscribers;
+
+        /// @return metrics of the web app in the prometheus text format
+        [[nodiscard]] std::string RenderMetrics(const TrackJobQueue &jobQueue) const;
+
+        void BroadcastProgress(const ProgressEvent &event) {
+            const std::lock_guard lock(mProgressMutex);
+            const auto subscribers = mProgressSubscribers.find(event.jobId);
+            if (subscribers == mProgressSubscribers.end())
+                return;
+
+            const auto msg = progress_event_to_json(event).dump();
+            for (const auto conn: subscribers->second) {
+                conn->send_text(msg);
+            }
+        }
+
+        crow::App<RequestMetrics, RequestBodyLimit> app;
         std::future<void> runner; // needed for async execution of webserver
+        // threads are declared last, so they stop before the data they use gets destroyed
+        std::mutex mRoadTilePrecomputerMutex;
+        std::jthread roadTilePrecomputer; // guarded by mRoadTilePrecomputerMutex
+        std::jthread graphLoader; // guarded by mReloadMutex, joins on destruction as loading a graph can't be stopped
 
         explicit BasicWebApp::impl(const std::string &filePath) try :
-            mGraph{FMIGraphReader::read(filePath)}, mGrid{mGraph, 0.01}, mPathfinding{mGraph} {
+            mGraph{std::make_shared<const GraphSnapshot>(filePath)} {
         } catch (...) {
         }
     };
 
-    std::string base64_decode(const std::string &in);
+    crow::json::wvalue node_distances_to_json(const std::vector<NodeDistance> &nodes);
+    crow::response json_response(std::string body);
+    crow::response json_error_response(int code, const std::string &error);
+    bool is_local_request(const crow::request &req);
+    bool parse_tile_y(const std::string &yFile, std::string_view extension, int &y);
+    crow::response hillshade_tile_response(const crow::request &req, const TileRaster &raster, TileCache &tileCache,
+                                           int z, int x, const std::string &yFile);
+    crow::response road_tile_response(const crow::request &req, const RoadTileIndex &roadTiles,
+                                      TileCache &roadTileCache, const std::string &graphVersion, int z, int x,
+                                      const std::string &yFile);
+    crow::response static_file_response(const crow::request &req, const std::string &filePath);
+    size_t get_resident_memory();
+    void write_search_stats(JsonWriter &json, const SearchStats &stats);
+    crow::json::wvalue histogram_to_json(const Histogram &histogram);
+
+    /// Only builds the json response if the client has no up to date copy of it, the client has to revalidate its copy
+    /// on every use since the data can change when the server restarts
+    /// @param etag Identifies the current version of the data behind the requested url
+    template<typename TBuild>
+    crow::response cached_json_response(const crow::request &req, const std::string &etag, TBuild build) {
+        crow::response res;
+        if (req.get_header_value("If-None-Match") == etag) {
+            res.code = 304;
+        } else {
+            res = crow::response(build());
+        }
+        res.set_header("ETag", etag);
+        res.set_header("Cache-Control", "no-cache");
+        return res;
+    }
 
     BasicWebApp::BasicWebApp(const std::string &filePath) try : pImpl{std::make_unique<impl>(filePath)} {
     } catch (...) {
     }
     BasicWebApp::~BasicWebApp() = default; // needed for compile pImpl ideom
 
-    void BasicWebApp::Start(TrackData &trackData) const {
+    void BasicWebApp::Start(TrackJobQueue &jobQueue) const {
 #ifdef NDEBUG
         pImpl->app.loglevel(crow::LogLevel::Error);
 #else
         pImpl->app.loglevel(crow::LogLevel::Info);
 #endif
+        pImpl->app.get_middleware<RequestMetrics>().pMetrics = &pImpl->mMetrics;
+
+        // only gets applied if the client accepts gzip
+        pImpl->app.use_compression(crow::compression::algorithm::GZIP);
+
+        // get static web files, uses the precompressed version of a file if there is one
+        // REQ: path of the file relative to the static folder
+        // RES: file content
+        CROW_ROUTE(pImpl->app, "/static/<path>")
+        ([](const crow::request &req, const std::string &filePath) { return static_file_response(req, filePath); });
 
         // get closest node to mouse click
         // REQ: latitude and longitude as double/double
         // RES: node id as json string
         CROW_ROUTE(pImpl->app, "/api/get_node/<double>/<double>")
-        ([&grid = pImpl->mGrid](const double lat, const double lon) {
-            const int closestNode = grid.GetClosestNode({lat, lon});
+        ([&impl = *pImpl](const double lat, const double lon) {
+            const int closestNode = impl.GetGraph()->grid.GetClosestNode({lat, lon});
 
             crow::json::wvalue x;
             x["nodeId"] = closestNode;
             return x;
         });
 
+        // get the closest nodes to a location
+        // REQ: latitude and longitude as double/double and number of nodes as int
+        // RES: list of node ids with their distance in meters as json string, closest node first
+        CROW_ROUTE(pImpl->app, "/api/get_nearest_nodes/<double>/<double>/<int>")
+        ([&impl = *pImpl](const double lat, const double lon, const int count) {
+            const auto graph = impl.GetGraph();
+            return node_distances_to_json(graph->grid.GetClosestNodes({lat, lon}, std::min(count, MAX_NEAREST_NODES)));
+        });
+
+        // get all nodes within a radius around a location
+        // REQ: latitude and longitude as double/double and radius in meters as double
+        // RES: list of node ids with their distance in meters as json string, closest node first
+        CROW_ROUTE(pImpl->app, "/api/get_nodes_in_radius/<double>/<double>/<double>")
+        ([&impl = *pImpl](const double lat, const double lon, const double radius) {
+            const auto graph = impl.GetGraph();
+            return node_distances_to_json(graph->grid.GetNodesInRadius({lat, lon}, std::min(radius, MAX_NODE_RADIUS)));
+        });
+
         // get position of node
         // REQ: node id as int
         // RES: latitude and longitude as json string
         CROW_ROUTE(pImpl->app, "/api/get_location/<int>")
-        ([&mGraph = pImpl->mGraph](const int node_id) {
-            auto [latitude, longitude] = mGraph.GetLocation(node_id);
+        ([&impl = *pImpl](const crow::request &req, const int node_id) {
+            // ids of clients that drafted their paths on a previous graph can be out of range
+            const auto graph = impl.GetGraph();
+            if (node_id < 0 || node_id >= graph->graph.GetNodeCount())
+                return json_error_response(404, std::vformat(ERROR_INVALID_NODE, std::make_format_args(node_id)));
 
-            crow::json::wvalue x;
-            x["lat"] = latitude;
-            x["lon"] = longitude;
-            return x;
+            return cached_json_response(req, graph->version, [&graph, node_id] {
+                auto [latitude, longitude] = graph->graph.GetLocation(node_id);
+
+                crow::json::wvalue x;
+                x["lat"] = latitude;
+                x["lon"] = longitude;
+                return x;
+            });
         });
 
         // get the shortest path between two nodes
-        // REQ: start and target node id as int/int
-        // RES: shortest path as json string
+        // REQ: start and target node id as int/int, optional url param 'stats' to attach the search counters and
+        //      optional url param 'format=polyline' for the compact format
+        // RES: shortest path as json string, either as list of nodes or as encoded polyline with a list of node ids
         CROW_ROUTE(pImpl->app, "/api/get_path/<int>/<int>")
-        ([&pathfinding = pImpl->mPathfinding, &mGraph = pImpl->mGraph](const int startNodeIndex,
-                                                                       const int targetNodeIndex) {
-            auto [nodeIds, distance] = pathfinding.CalculatePath(startNodeIndex, targetNodeIndex);
+        ([&impl = *pImpl](const crow::request &req, const int startNodeIndex, const int targetNodeIndex) {
+            const auto graph = impl.GetGraph();
+            for (const int nodeId: {startNodeIndex, targetNodeIndex}) {
+                if (nodeId < 0 || nodeId >= graph->graph.GetNodeCount())
+                    return json_error_response(404, std::vformat(ERROR_INVALID_NODE, std::make_format_args(nodeId)));
+            }
 
-            std::vector<crow::json::wvalue> path;
-            path.reserve(nodeIds.size());
-            for (const auto nodeId: nodeIds) {
-                auto [latitude, longitude] = mGraph.GetLocation(nodeId);
-                crow::json::wvalue node;
-                node["nodeId"] = nodeId;
-                node["lat"] = latitude;
-                node["lon"] = longitude;
+            const bool attachStats = req.url_params.get("stats") != nullptr;
+            const char *format = req.url_params.get("format");
+            const bool usePolyline = format != nullptr && std::string_view(format) == "polyline";
+            const auto buildPath = [&] {
+                SearchStats stats;
+                std::shared_ptr<const Path> path;
+                if (attachStats) {
+                    // the counters only exist for a search that actually runs, its path still refreshes the cache
+                    path = std::make_shared<const Path>(
+                            graph->pathfinding.CalculatePath(startNodeIndex, targetNodeIndex, stats));
+                    impl.mSearchStats.Record(stats);
+                    impl.mRouteCache.Put(startNodeIndex, targetNodeIndex, graph->version, path);
+                } else {
+                    path = get_route(impl.mRouteCache, graph->pathfinding, impl.mSearchStats, graph->version,
+                                     startNodeIndex, targetNodeIndex);
+                }
+                const auto &[nodeIds, distance] = *path;
 
-                path.push_back(node);
-            }
+                // long routes have many thousand nodes, so they get written without a wvalue per node
+                JsonWriter json(nodeIds.size() * (usePolyline ? PATH_POLYLINE_BYTES : PATH_NODE_BYTES) + 256);
+                json.BeginObject();
+                json.Key("distance").Int(distance);
+                if (usePolyline) {
+                    json.Key("polyline").String(encode_polyline(graph->graph, nodeIds));
+                    json.Key("precision").Int(POLYLINE_PRECISION);
+                    json.Key("nodeIds").BeginArray();
+                    for (const auto nodeId: nodeIds) {
+                        json.Int(nodeId);
+                    }
+                    json.EndArray();
+                } else {
+                    json.Key("nodes").BeginArray();
+                    for (const auto nodeId: nodeIds) {
+                        auto [latitude, longitude] = graph->graph.GetLocation(nodeId);
+                        json.BeginObject();
+                        json.Key("nodeId").Int(nodeId);
+                        json.Key("lat").Double(latitude);
+                        json.Key("lon").Double(longitude);
+                        json.EndObject();
+                    }
+                    json.EndArray();
+                }
+                if (attachStats) {
+                    json.Key("stats");
+                    write_search_stats(json, stats);
+                }
+                json.EndObject();
+                return json_response(json.Take());
+            };
 
+            // search counters differ with every request, so only plain paths can be cached
+            if (attachStats)
+                return crow::response(buildPath());
+            return cached_json_response(req, graph->version, buildPath);
+        });
+
+        // snaps a clicked location to the closest node and routes to it from the previous waypoint
+        // REQ: latitude and longitude as double/double, optional url param 'from' with the node id of the previous
+        //      waypoint
+        // RES: closest node id with its location and, if 'from' is given, the path to it as encoded polyline or error
+        //      msg if 'from' is no valid node id
+        CROW_ROUTE(pImpl->app, "/api/snap_route/<double>/<double>")
+        ([&impl = *pImpl](const crow::request &req, const double lat, const double lon) {
+            const auto graph = impl.GetGraph();
             crow::json::wvalue x;
+            const int nodeId = graph->grid.GetClosestNode({lat, lon});
+            x["nodeId"] = nodeId;
+            if (nodeId == -1)
+                return x;
+
+            const auto [latitude, longitude] = graph->graph.GetLocation(nodeId);
+            x["lat"] = latitude;
+            x["lon"] = longitude;
+
+            const char *from = req.url_params.get("from");
+            if (from == nullptr)
+                return x;
+            const auto fromEnd = from + std::strlen(from);
+            int fromNodeId = -1;
+            const auto [ptr, ec] = std::from_chars(from, fromEnd, fromNodeId);
+            if (ec != std::errc() || ptr != fromEnd || fromNodeId < 0 || fromNodeId >= graph->graph.GetNodeCount()) {
+                crow::json::wvalue error;
+                error["error"] = std::vformat(ERROR_INVALID_NODE, std::make_format_args(from));
+                return error;
+            }
+
+            // create_track reuses the cached path of every leg added this way
+            const auto path = get_route(impl.mRouteCache, graph->pathfinding, impl.mSearchStats, graph->version,
+                                        fromNodeId, nodeId);
+            const auto &[nodeIds, distance] = *path;
+
             x["distance"] = distance;
-            x["nodes"] = std::move(path);
+            x["polyline"] = encode_polyline(graph->graph, nodeIds);
+            x["precision"] = POLYLINE_PRECISION;
+            x["nodeIds"] = std::vector<crow::json::wvalue>(nodeIds.begin(), nodeIds.end());
+            return x;
+        });
+
+        // gets the aggregated counters of all path queries since the start of the web app
+        // RES: histogram for each counter as json string
+        CROW_ROUTE(pImpl->app, "/api/get_search_stats")
+        ([&searchStats = pImpl->mSearchStats]() {
+            crow::json::wvalue x;
+            x["settledNodes"] = histogram_to_json(searchStats.settledNodes);
+            x["relaxedEdges"] = histogram_to_json(searchStats.relaxedEdges);
+            x["heapPushes"] = histogram_to_json(searchStats.heapPushes);
+            x["heapPops"] = histogram_to_json(searchStats.heapPops);
+            x["resetTimeUs"] = histogram_to_json(searchStats.resetTimeUs);
+            x["totalTimeUs"] = histogram_to_json(searchStats.totalTimeUs);
             return x;
         });
 
         // get extends rect of a raster
-        // REQ: base64 encoded json obj containing filepath to raster and optionally custom proj ref
-        // RES: 4 points representing the corners of the raster rect
-        CROW_ROUTE(pImpl->app, "/api/get_raster_extend/<string>")
-        ([](const std::string &base64JsonObj) {
-            auto rasterJson = crow::json::load(base64_decode(base64JsonObj));
+        // REQ: POST json obj containing filepath to raster and optionally custom proj ref
+        // RES: 4 points representing the corners of the raster rect and the id of the raster for tile urls
+        CROW_ROUTE(pImpl->app, "/api/get_raster_extend")
+                .methods(crow::HTTPMethod::Post)([&impl = *pImpl](const crow::request &req) -> crow::response {
+            const auto rasterJson = crow::json::load(req.body);
+            if (!rasterJson || !rasterJson.has("filePath")) {
+                crow::json::wvalue x;
+                x["error"] = ERROR_INVALID_JSON;
+                return x;
+            }
 
             std::string rasterFilePath = rasterJson["filePath"].s();
-            const Raster::GDALDatasetWrapper dataset(rasterFilePath);
+            // only opens the file if it is not cached yet or changed since
+            const auto metadata = impl.mRasterCache.GetMetadata(rasterFilePath);
 
-            if (!dataset.IsValid()) {
+            if (!metadata) {
                 crow::json::wvalue x;
                 x["error"] = std::vformat(ERROR_INVALID_FILE, std::make_format_args(rasterFilePath));
                 return x;
             }
 
-            auto srcProjRef = dataset.GetProjectionRef();
-            if (!srcProjRef.IsValid()) {
+            auto srcProjRef = Raster::ProjectionWrapper(metadata->projRef);
+            if (!metadata->projRefValid) {
                 // check if custom proj ref was provided
                 if (!rasterJson.has("projRef")) {
                     crow::json::wvalue x;
@@ -130,124 +558,811 @@ namespace TrackMapper::Web {
                 }
             }
 
-            auto extends = Raster::getDatasetExtends(dataset);
-            if (auto success = Raster::reprojectPoints(extends, srcProjRef, Raster::osmPointsProjRef); !success) {
+            const auto extends = impl.mRasterCache.GetExtends(rasterFilePath, srcProjRef);
+            if (!extends) {
                 crow::json::wvalue x;
                 x["error"] = ERROR_FAILED_PROJ;
                 return x;
             }
 
-            std::vector<crow::json::wvalue> corners;
-            for (const auto [lat, lon]: extends) {
-                crow::json::wvalue node;
-                node["lat"] = lat;
-                node["lon"] = lon;
+            JsonWriter json(256);
+            json.BeginObject();
+            json.Key("corners").BeginArray();
+            for (const auto [lat, lon]: *extends) {
+                json.BeginObject();
+                json.Key("lat").Double(lat);
+                json.Key("lon").Double(lon);
+                json.EndObject();
+            }
+            json.EndArray();
+            json.Key("rasterId").Int(impl.AddTileRaster({rasterFilePath, srcProjRef, *extends}));
+            json.EndObject();
+            return json_response(json.Take());
+        });
 
-                corners.push_back(node);
+        // gets the heights along a path, to preview it before creating the track
+        // REQ: POST json obj containing the node ids of the waypoints as 'path', the raster file paths as 'rasters',
+        // optionally a custom proj ref as 'wkt' and the distance between samples in meters as 'spacing'
+        // RES: heights in decimeters at equal distances along the path, null where no raster covers the path
+        CROW_ROUTE(pImpl->app, "/api/get_elevation_profile")
+                .methods(crow::HTTPMethod::Post)([&impl = *pImpl](const crow::request &req) -> crow::response {
+            const auto profileJson = crow::json::load(req.body);
+            if (!profileJson || !profileJson.has("path") || !profileJson.has("rasters")) {
+                crow::json::wvalue x;
+                x["error"] = ERROR_INVALID_JSON;
+                return x;
             }
 
-            crow::json::wvalue x;
-            x["corners"] = std::move(corners);
-            return x;
-        });
+            const auto waypointsJson = profileJson["path"].lo();
+            const auto rastersJson = profileJson["rasters"].lo();
+            if (waypointsJson.size() < 2) {
+                crow::json::wvalue x;
+                x["error"] = ERROR_NO_PATH;
+                return x;
+            }
+            if (rastersJson.empty()) {
+                crow::json::wvalue x;
+                x["error"] = ERROR_NO_RASTER;
+                return x;
+            }
 
-        // starts track creation
-        // REQ: base64 encoded json obj containing data for track creation
-        // RES: error msg if error happens
-        CROW_ROUTE(pImpl->app, "/api/create_track/<string>")
-        ([&trackData, &mGraph = pImpl->mGraph, &pathfinding = pImpl->mPathfinding](const std::string &base64JsonObj) {
-            const auto trackJson = crow::json::load(base64_decode(base64JsonObj));
-
-            trackData.SetProgress("Parsing Track Data");
-
-            const std::string name = trackJson["name"].s();
-            const std::string outPath = trackJson["output"].s();
-            const std::string wkt = trackJson["wkt"].s();
-            // if lo() misses const modifier please update crow past commit
-            // https://github.com/CrowCpp/Crow/commit/a9e7b7321b0f7ef082cf509b762755136683beaf
-            // or manually modify header
-            const auto rastersJson = trackJson["rasters"].lo();
-            const auto pathsJson = trackJson["paths"].lo();
-
-            trackData.name = name;
-
-            // gets validated when track gets created
-            trackData.outputPath = outPath;
-            trackData.projRef = Raster::ProjectionWrapper(wkt);
-
-            trackData.rasterFiles.reserve(rastersJson.size());
-            for (const auto &rasterPath: rastersJson) {
-                trackData.rasterFiles.push_back(rasterPath.s());
-            }
-
-            trackData.paths.resize(pathsJson.size());
-            for (int pathIdx = 0; pathIdx < pathsJson.size(); ++pathIdx) {
-                const auto pathJson = pathsJson[pathIdx].lo();
-
-                // add first node to path
-                auto prevNode = static_cast<int>(pathJson[0].i());
-                const auto [lat, lng] = mGraph.GetLocation(prevNode);
-                trackData.paths[pathIdx].emplace_back(lat, lng);
-
-                // querry shortest path for each segment and add all of its nodes
-                for (int segmentIdx = 1; segmentIdx < pathJson.size(); ++segmentIdx) {
-                    const auto curNode = static_cast<int>(pathJson[segmentIdx]);
-                    auto nodes = pathfinding.CalculatePath(prevNode, curNode).nodeIds;
-                    // skip first node to not add it twice from the previous segment
-                    for (int i = 1; i < nodes.size(); ++i) {
-                        const auto [lat, lng] = mGraph.GetLocation(nodes[i]);
-                        trackData.paths[pathIdx].emplace_back(lat, lng);
+            // a custom proj ref replaces the ones of all rasters, same as for the track creation
+            Raster::ProjectionWrapper customProjRef;
+            if (profileJson.has("wkt") && !profileJson["wkt"].s().empty()) {
+                std::string wkt = profileJson["wkt"].s();
+                customProjRef = Raster::ProjectionWrapper(wkt);
+                if (!customProjRef.IsValid()) {
+                    crow::json::wvalue x;
+                    x["error"] = std::vformat(ERROR_INVALID_PROJ, std::make_format_args(wkt));
+                    return x;
+                }
+            }
+
+            const auto graph = impl.GetGraph();
+            std::vector<Raster::OSMPoint> path;
+            int prevNode = -1;
+            for (const auto &nodeJson: waypointsJson) {
+                const auto nodeId = nodeJson.t() == crow::json::type::Number ? nodeJson.i() : -1;
+                if (nodeId < 0 || nodeId >= graph->graph.GetNodeCount()) {
+                    crow::json::wvalue x;
+                    x["error"] = std::vformat(ERROR_INVALID_NODE, std::make_format_args(nodeId));
+                    return x;
+                }
+
+                const auto curNode = static_cast<int>(nodeId);
+                if (prevNode < 0) {
+                    const auto [lat, lng] = graph->graph.GetLocation(curNode);
+                    path.emplace_back(lat, lng);
+                } else {
+                    impl.AppendRoute(*graph, path, prevNode, curNode);
+                }
+                prevNode = curNode;
+            }
+
+            const double distance = path_length(path);
+            double spacing = profileJson.has("spacing") ? profileJson["spacing"].d() : 10;
+            spacing = std::max({spacing, MIN_PROFILE_SPACING, distance / (MAX_PROFILE_SAMPLES - 1)});
+            const auto samples = resample_path(path, spacing);
+
+            // earlier rasters take precedence where rasters overlap, same as for the track creation
+            std::vector heights(samples.size(), std::numeric_limits<float>::quiet_NaN());
+            for (const auto &rasterJson: rastersJson) {
+                std::string rasterFilePath = rasterJson.s();
+                const auto metadata = impl.mRasterCache.GetMetadata(rasterFilePath);
+                if (!metadata) {
+                    crow::json::wvalue x;
+                    x["error"] = std::vformat(ERROR_INVALID_FILE, std::make_format_args(rasterFilePath));
+                    return x;
+                }
+
+                auto srcProjRef = customProjRef;
+                if (!srcProjRef.IsValid()) {
+                    if (!metadata->projRefValid) {
+                        crow::json::wvalue x;
+                        x["error"] = ERROR_MISSING_PROJ;
+                        return x;
                     }
-                    prevNode = curNode;
+                    srcProjRef = Raster::ProjectionWrapper(metadata->projRef);
                 }
+
+                // the cached extends allow skipping rasters the path does not cross without opening them
+                const auto extends = impl.mRasterCache.GetExtends(rasterFilePath, srcProjRef);
+                if (!extends) {
+                    crow::json::wvalue x;
+                    x["error"] = ERROR_FAILED_PROJ;
+                    return x;
+                }
+                if (!has_missing_heights_in(samples, heights, *extends))
+                    continue;
+
+                const Raster::GDALDatasetWrapper dataset(rasterFilePath);
+                if (!dataset.IsValid()) {
+                    crow::json::wvalue x;
+                    x["error"] = std::vformat(ERROR_INVALID_FILE, std::make_format_args(rasterFilePath));
+                    return x;
+                }
+                if (!Raster::sampleRasterHeights(dataset, srcProjRef, samples, heights)) {
+                    crow::json::wvalue x;
+                    x["error"] = ERROR_FAILED_PROJ;
+                    return x;
+                }
+            }
+
+            const auto stats = get_profile_stats(heights);
+            JsonWriter json(heights.size() * 8 + 256);
+            json.BeginObject();
+            json.Key("spacing").Double(spacing);
+            json.Key("distance").Double(distance);
+            // decimeters as integers keep the response small while being more exact than any height raster
+            json.Key("heights").BeginArray();
+            for (const float height: heights) {
+                if (std::isnan(height)) {
+                    json.Null();
+                } else {
+                    json.Int(std::lround(height * 10));
+                }
+            }
+            json.EndArray();
+            // the float heights would print with the digits of a double, so all heights get rounded to decimeters
+            if (!std::isnan(stats.minHeight)) {
+                json.Key("minHeight").Double(std::round(static_cast<double>(stats.minHeight) * 10) / 10);
+                json.Key("maxHeight").Double(std::round(static_cast<double>(stats.maxHeight) * 10) / 10);
+            }
+            json.Key("ascent").Double(std::round(stats.ascent * 10) / 10);
+            json.Key("descent").Double(std::round(stats.descent * 10) / 10);
+            json.EndObject();
+            return json_response(json.Take());
+        });
+
+        // gets the hillshade of a raster as xyz tile, to show the terrain on the map
+        // REQ: tile coordinates with the y coordinate as '<y>.png' and the raster id from get_raster_extend as query
+        // parameter 'raster'
+        // RES: png image, empty with status 204 if the raster does not overlap the tile, error json on failure
+        CROW_ROUTE(pImpl->app, "/api/tiles/hillshade/<int>/<int>/<string>")
+        ([&impl = *pImpl](const crow::request &req, const int z, const int x, const std::string &yFile) {
+            int rasterId = -1;
+            if (const auto idParam = req.url_params.get("raster"); idParam != nullptr) {
+                std::from_chars(idParam, idParam + std::strlen(idParam), rasterId);
+            }
+            const auto raster = impl.GetTileRaster(rasterId);
+            if (!raster)
+                return json_error_response(404, std::vformat(ERROR_UNKNOWN_RASTER, std::make_format_args(rasterId)));
+
+            return hillshade_tile_response(req, *raster, impl.mTileCache, z, x, yFile);
+        });
+
+        // gets the edges of the graph as mapbox vector tile, to show the routable roads on the map
+        // REQ: tile coordinates with the y coordinate as '<y>.pbf'
+        // RES: vector tile with the layer 'roads', empty with status 204 if the tile contains no roads
+        CROW_ROUTE(pImpl->app, "/api/tiles/roads/<int>/<int>/<string>")
+        ([&impl = *pImpl](const crow::request &req, const int z, const int x, const std::string &yFile) {
+            const auto graph = impl.GetGraph();
+            return road_tile_response(req, graph->roadTiles, impl.mRoadTileCache, graph->version, z, x, yFile);
+        });
+
+        // enqueues a track for creation
+        // REQ: POST json obj containing data for track creation
+        // RES: id of the track job or error msg if error happens
+        CROW_ROUTE(pImpl->app, "/api/create_track")
+                .methods(crow::HTTPMethod::Post)([&jobQueue, &impl = *pImpl](const crow::request &req) {
+            // the body only holds node ids and file paths and is capped by RequestBodyLimit, so parsing it into a
+            // tree costs far less than resolving the paths and isn't worth a hand written streaming parser
+            const auto trackJson = crow::json::load(req.body);
+            if (!trackJson) {
+                crow::json::wvalue x;
+                x["error"] = ERROR_INVALID_JSON;
+                return x;
             }
 
-            trackData.SetPopulated();
+            const auto trackData = std::make_shared<TrackData>();
+            if (const auto error = read_track_json(trackJson, *impl.GetGraph(), *trackData); !error.empty()) {
+                crow::json::wvalue x;
+                x["error"] = error;
+                return x;
+            }
+
+            trackData->SetProgressListener(
+                    [&impl, stage = 0, stageStartTime = 0.0](const ProgressEvent &event) mutable {
+                        // a stage ends when the next one starts or the whole track is finished
+                        if (event.stage != stage || event.finished) {
+                            if (stage > 0 && stage <= Metrics::STAGES.size()) {
+                                const auto durationMs = std::llround(1000 * (event.elapsedSeconds - stageStartTime));
+                                impl.mMetrics.stageDurationMs[stage - 1].Record(durationMs);
+                            }
+                            stage = event.finished ? 0 : event.stage;
+                            stageStartTime = event.elapsedSeconds;
+                        }
+                        if (event.finished) {
+                            impl.mMetrics.finishedJobs.fetch_add(1, std::memory_order_relaxed);
+                        } else if (!event.error.empty()) {
+                            impl.mMetrics.failedJobs.fetch_add(1, std::memory_order_relaxed);
+                        }
+
+                        impl.BroadcastProgress(event);
+                    });
+
+            const int jobId = jobQueue.Enqueue(trackData);
+            if (jobId < 0) {
+                crow::json::wvalue x;
+                x["error"] = ERROR_QUEUE_FULL;
+                return x;
+            }
 
             crow::json::wvalue x;
             x["status"] = "ok";
+            x["jobId"] = jobId;
             return x;
         });
 
-        // gets progress msg of track creation progress
-        // RES: string containing progress msg
-        CROW_ROUTE(pImpl->app, "/api/get_progress")
-        ([&trackData]() {
+        // cancels a pending or running track job
+        // REQ: POST with job id as int
+        // RES: error msg if error happens
+        CROW_ROUTE(pImpl->app, "/api/cancel_track/<int>")
+                .methods(crow::HTTPMethod::Post)([&jobQueue](int jobId) {
             crow::json::wvalue x;
-            x["progress"] = trackData.GetProgress();
-            x["finished"] = trackData.IsFinished();
-            if (const auto error = trackData.GetError(); !error.empty()) {
-                x["error"] = error;
-                trackData.SetError("");
+            if (!jobQueue.Cancel(jobId)) {
+                x["error"] = std::vformat(ERROR_UNKNOWN_JOB, std::make_format_args(jobId));
+                return x;
+            }
+            x["status"] = "ok";
+            return x;
+        });
+
+        // gets the progress of all known track jobs
+        // RES: list of progress events as json string, oldest job first
+        CROW_ROUTE(pImpl->app, "/api/get_jobs")
+        ([&jobQueue]() {
+            std::vector<crow::json::wvalue> jobs;
+            for (const auto jobId: jobQueue.GetJobIds()) {
+                if (const auto trackData = jobQueue.GetJob(jobId)) {
+                    jobs.push_back(progress_event_to_json(trackData->GetProgressEvent()));
+                }
             }
+
+            crow::json::wvalue x;
+            x["running"] = jobQueue.GetRunningJobCount();
+            x["pending"] = jobQueue.GetPendingJobCount();
+            x["jobs"] = std::move(jobs);
             return x;
         });
 
+        // gets progress of a track job, fallback for clients without websocket support
+        // REQ: job id as int
+        // RES: progress event as json string
+        CROW_ROUTE(pImpl->app, "/api/get_progress/<int>")
+        ([&jobQueue](int jobId) {
+            const auto trackData = jobQueue.GetJob(jobId);
+            if (!trackData) {
+                crow::json::wvalue x;
+                x["error"] = std::vformat(ERROR_UNKNOWN_JOB, std::make_format_args(jobId));
+                return x;
+            }
+            return progress_event_to_json(trackData->GetProgressEvent());
+        });
+
+        // gets the finest preview mesh of a track job rendered so far, the progress events announce new levels
+        // REQ: job id as int
+        // RES: preview as binary gltf, 204 if no preview has been rendered yet
+        CROW_ROUTE(pImpl->app, "/api/get_preview/<int>")
+        ([&jobQueue](int jobId) {
+            const auto trackData = jobQueue.GetJob(jobId);
+            if (!trackData)
+                return json_error_response(404, std::vformat(ERROR_UNKNOWN_JOB, std::make_format_args(jobId)));
+
+            int level;
+            const auto preview = trackData->GetPreview(level);
+            if (!preview)
+                return crow::response(204);
+
+            crow::response res(*preview);
+            res.set_header("Content-Type", "model/gltf-binary");
+            res.set_header("X-Preview-Level", std::to_string(level));
+            res.set_header("Cache-Control", "no-store"); // gets replaced by finer levels under the same url
+            return res;
+        });
+
+        // pushes every progress change of the track jobs a client subscribed to
+        // REQ: job id as text message, once per job that should be followed
+        // RES: progress event as json string, the current state of the job is sent right after subscribing
+        CROW_WEBSOCKET_ROUTE(pImpl->app, "/api/progress_stream")
+                .onmessage([&jobQueue, &impl = *pImpl](crow::websocket::connection &conn, const std::string &data,
+                                                       bool) {
+                    int jobId = -1;
+                    std::from_chars(data.data(), data.data() + data.size(), jobId);
+                    const auto trackData = jobQueue.GetJob(jobId);
+                    if (!trackData) {
+                        crow::json::wvalue x;
+                        x["jobId"] = jobId;
+                        x["error"] = std::vformat(ERROR_UNKNOWN_JOB, std::make_format_args(jobId));
+                        conn.send_text(x.dump());
+                        return;
+                    }
+
+                    // sent under the lock, so no event of the job can overtake the current state
+                    const std::lock_guard lock(impl.mProgressMutex);
+                    impl.mProgressSubscribers[jobId].insert(&conn);
+                    conn.send_text(progress_event_to_json(trackData->GetProgressEvent()).dump());
+                })
+                .onclose([&impl = *pImpl](crow::websocket::connection &conn, const std::string &, uint16_t) {
+                    const std::lock_guard lock(impl.mProgressMutex);
+                    for (auto it = impl.mProgressSubscribers.begin(); it != impl.mProgressSubscribers.end();) {
+                        it->second.erase(&conn);
+                        it = it->second.empty() ? impl.mProgressSubscribers.erase(it) : std::next(it);
+                    }
+                });
+
+        // loads another graph in the background, requests keep using the current graph until the new one is ready
+        // REQ: POST json obj containing the filepath to a fmi or osm.pbf file, only accepted from the local machine
+        // RES: status 202 once loading started or error msg if error happens
+        CROW_ROUTE(pImpl->app, "/admin/reload_graph")
+                .methods(crow::HTTPMethod::Post)([&impl = *pImpl](const crow::request &req) {
+            if (!is_local_request(req))
+                return json_error_response(403, ERROR_NOT_LOCAL);
+
+            const auto reloadJson = crow::json::load(req.body);
+            if (!reloadJson || !reloadJson.has("filePath"))
+                return json_error_response(400, ERROR_INVALID_JSON);
+
+            std::string graphFilePath = reloadJson["filePath"].s();
+            if (!std::filesystem::is_regular_file(graphFilePath))
+                return json_error_response(400, std::vformat(ERROR_INVALID_FILE, std::make_format_args(graphFilePath)));
+
+            if (!impl.StartGraphReload(graphFilePath))
+                return json_error_response(409, ERROR_RELOAD_RUNNING);
+
+            crow::json::wvalue x;
+            x["status"] = "loading";
+            crow::response res(x);
+            res.code = 202;
+            return res;
+        });
+
+        // gets the state of the loaded graph
+        // RES: version and size of the current graph, whether another graph is being loaded and the error of the last
+        // reload if it failed
+        CROW_ROUTE(pImpl->app, "/admin/graph")
+        ([&impl = *pImpl](const crow::request &req) {
+            if (!is_local_request(req))
+                return json_error_response(403, ERROR_NOT_LOCAL);
+
+            const auto graph = impl.GetGraph();
+            crow::json::wvalue x;
+            x["version"] = graph->version;
+            x["nodeCount"] = graph->graph.GetNodeCount();
+            x["edgeCount"] = graph->graph.GetEdgeCount();
+
+            const std::lock_guard lock(impl.mReloadMutex);
+            x["reloading"] = impl.mReloading;
+            if (!impl.mReloadError.empty()) {
+                x["error"] = impl.mReloadError;
+            }
+            return crow::response(x);
+        });
+
+        // gets the metrics of the web app for scraping by prometheus
+        // RES: metrics in the prometheus text format
+        CROW_ROUTE(pImpl->app, "/metrics")
+        ([&jobQueue, &impl = *pImpl]() {
+            crow::response res(impl.RenderMetrics(jobQueue));
+            res.set_header("Content-Type", "text/plain; version=0.0.4");
+            return res;
+        });
+
         std::cout << "Starting web app.." << std::endl;
+        pImpl->PrecomputeRoadTiles(pImpl->GetGraph());
+
         pImpl->runner = pImpl->app.port(18080).run_async();
     }
     void BasicWebApp::Stop() const { pImpl->app.stop(); }
 
-    // copied from https://stackoverflow.com/questions/180947/base64-decode-snippet-in-c
-    std::string base64_decode(const std::string &in) {
-        std::string out;
+    std::string BasicWebApp::ReadTrackJob(const std::string &json, TrackData &data) const {
+        const auto trackJson = crow::json::load(json);
+        if (!trackJson)
+            return ERROR_INVALID_JSON;
+        return read_track_json(trackJson, *pImpl->GetGraph(), data);
+    }
+
+    bool BasicWebApp::ResolvePaths(TrackData &data) const {
+        auto &impl = *pImpl;
+
+        // the node ids only stay valid for the graph the paths were drawn on
+        const auto graph = impl.GetGraph();
+        if (graph->version != data.graphVersion) {
+            data.SetError(ERROR_GRAPH_CHANGED);
+            return false;
+        }
+
+        data.paths.clear();
+        data.paths.resize(data.waypointNodes.size());
+        for (int pathIdx = 0; pathIdx < data.waypointNodes.size(); ++pathIdx) {
+            const auto &waypoints = data.waypointNodes[pathIdx];
+            if (waypoints.empty())
+                continue;
+
+            // add first node to path
+            auto prevNode = waypoints[0];
+            const auto [lat, lng] = graph->graph.GetLocation(prevNode);
+            data.paths[pathIdx].emplace_back(lat, lng);
+
+            // gets the shortest path for each segment, usually from the cache, and adds all of its nodes
+            for (int segmentIdx = 1; segmentIdx < waypoints.size(); ++segmentIdx) {
+                if (data.IsCancelled())
+                    return false;
+
+                const auto curNode = waypoints[segmentIdx];
+                impl.AppendRoute(*graph, data.paths[pathIdx], prevNode, curNode);
+                prevNode = curNode;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Fills the data of a track job from its json description, same for the web ui and batch files
+     * @param trackJson object with 'name', 'output', 'rasters', 'paths' and optionally 'wkt', each path is a list of
+     * waypoints given as node id or as object with 'lat' and 'lon' that gets snapped to the closest node
+     * @return error msg, empty if the job is valid
+     * @note Output folder, rasters and projection get validated when the track gets created
+     */
+    std::string read_track_json(const crow::json::rvalue &trackJson, const GraphSnapshot &graph, TrackData &data) {
+        if (!trackJson.has("name") || !trackJson.has("output") || !trackJson.has("rasters") || !trackJson.has("paths"))
+            return ERROR_INVALID_JSON;
 
-        std::vector T(256, -1);
-        for (int i = 0; i < 64; i++)
-            T["ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i]] = i;
+        data.name = trackJson["name"].s();
+        data.outputPath = trackJson["output"].s();
+        data.projRef = Raster::ProjectionWrapper(trackJson.has("wkt") ? std::string(trackJson["wkt"].s()) : "");
+
+        // if lo() misses const modifier please update crow past commit
+        // https://github.com/CrowCpp/Crow/commit/a9e7b7321b0f7ef082cf509b762755136683beaf
+        // or manually modify header
+        const auto rastersJson = trackJson["rasters"].lo();
+        data.rasterFiles.reserve(rastersJson.size());
+        for (const auto &rasterPath: rastersJson) {
+            data.rasterFiles.push_back(rasterPath.s());
+        }
 
-        int val = 0, valb = -8;
-        for (const unsigned char c: in) {
-            if (T[c] == -1)
-                break;
-            val = (val << 6) + T[c];
-            valb += 6;
-            if (valb >= 0) {
-                out.push_back(static_cast<char>((val >> valb) & 0xFF));
-                valb -= 8;
+        // only the waypoints get stored, the paths between them get resolved by the job off the request thread
+        const auto pathsJson = trackJson["paths"].lo();
+        data.graphVersion = graph.version;
+        data.waypointNodes.resize(pathsJson.size());
+        for (int pathIdx = 0; pathIdx < pathsJson.size(); ++pathIdx) {
+            for (const auto &waypointJson: pathsJson[pathIdx].lo()) {
+                int64_t nodeId = -1;
+                if (waypointJson.t() == crow::json::type::Number) {
+                    nodeId = waypointJson.i();
+                } else if (waypointJson.t() == crow::json::type::Object && waypointJson.has("lat") &&
+                           waypointJson.has("lon")) {
+                    nodeId = graph.grid.GetClosestNode({waypointJson["lat"].d(), waypointJson["lon"].d()});
+                }
+
+                if (nodeId < 0 || nodeId >= graph.graph.GetNodeCount())
+                    return std::vformat(ERROR_INVALID_NODE, std::make_format_args(nodeId));
+                data.waypointNodes[pathIdx].push_back(static_cast<int>(nodeId));
             }
         }
-        return out;
+        return "";
+    }
+
+    std::shared_ptr<const Path> get_route(RouteCache &routeCache, const DijkstraPathfinding &pathfinding,
+                                          SearchStatsHistograms &searchStats, const std::string &graphVersion,
+                                          const int startNodeIndex, const int targetNodeIndex) {
+        if (auto path = routeCache.Get(startNodeIndex, targetNodeIndex, graphVersion))
+            return path;
+
+        SearchStats stats;
+        auto path = std::make_shared<const Path>(pathfinding.CalculatePath(startNodeIndex, targetNodeIndex, stats));
+        searchStats.Record(stats);
+        routeCache.Put(startNodeIndex, targetNodeIndex, graphVersion, path);
+        return path;
+    }
+
+    crow::json::wvalue progress_event_to_json(const ProgressEvent &event) {
+        crow::json::wvalue x;
+        x["jobId"] = event.jobId;
+        x["progress"] = event.progress;
+        x["stage"] = event.stage;
+        x["stageCount"] = event.stageCount;
+        x["stageFraction"] = event.stageFraction;
+        x["elapsed"] = event.elapsedSeconds;
+        x["finished"] = event.finished;
+        x["previewLevel"] = event.previewLevel;
+        if (!event.error.empty()) {
+            x["error"] = event.error;
+        }
+        return x;
+    }
+
+    crow::json::wvalue node_distances_to_json(const std::vector<NodeDistance> &nodes) {
+        std::vector<crow::json::wvalue> list;
+        list.reserve(nodes.size());
+        for (const auto [nodeIndex, distance]: nodes) {
+            crow::json::wvalue node;
+            node["nodeId"] = nodeIndex;
+            node["distance"] = distance;
+            list.push_back(std::move(node));
+        }
+
+        crow::json::wvalue x;
+        x["nodes"] = std::move(list);
+        return x;
+    }
+
+    crow::response json_response(std::string body) {
+        crow::response res(std::move(body));
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+
+    crow::response json_error_response(const int code, const std::string &error) {
+        crow::json::wvalue x;
+        x["error"] = error;
+        crow::response res(code, x.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+
+    bool is_local_request(const crow::request &req) {
+        const std::string_view address = req.remote_ip_address;
+        return address == "127.0.0.1" || address == "::1" || address == "::ffff:127.0.0.1";
+    }
+
+    bool parse_tile_y(const std::string &yFile, const std::string_view extension, int &y) {
+        if (!yFile.ends_with(extension))
+            return false;
+
+        const auto yEnd = yFile.data() + yFile.size() - extension.size();
+        const auto [ptr, ec] = std::from_chars(yFile.data(), yEnd, y);
+        return ec == std::errc() && ptr == yEnd;
+    }
+
+    crow::response hillshade_tile_response(const crow::request &req, const TileRaster &raster, TileCache &tileCache,
+                                           const int z, const int x, const std::string &yFile) {
+        int y = -1;
+        if (!parse_tile_y(yFile, ".png", y) || !Raster::isValidTile(z, x, y))
+            return json_error_response(400, std::vformat(ERROR_INVALID_TILE, std::make_format_args(z, x, yFile)));
+
+        // skips reading the raster for the many tiles around it when zoomed in
+        if (!Raster::tileOverlaps(Raster::getTileBounds(z, x, y), raster.extends))
+            return crow::response(204);
+
+        // tiles of a changed raster file get a different key, so outdated tiles are never served
+        const auto sourceHash = std::hash<std::string>{}(raster.filePath + '\n' + raster.projRef.Get() + '\n' +
+                                                         get_file_version(raster.filePath));
+        const auto etag = std::format("\"{:016x}\"", sourceHash);
+
+        crow::response res;
+        res.set_header("ETag", etag);
+        res.set_header("Cache-Control", "no-cache");
+        if (req.get_header_value("If-None-Match") == etag) {
+            res.code = 304;
+            return res;
+        }
+
+        const auto key = std::format("hillshade/{:016x}/{}/{}/{}.png", sourceHash, z, x, y);
+        auto tile = tileCache.Get(key);
+        if (!tile) {
+            auto png = Raster::renderHillshadeTile(raster.filePath, raster.projRef, z, x, y);
+            if (png.empty())
+                return json_error_response(
+                        500, std::vformat(ERROR_INVALID_FILE, std::make_format_args(raster.filePath)));
+
+            tileCache.Put(key, png);
+            tile = std::make_shared<const std::string>(std::move(png));
+        }
+
+        res.set_header("Content-Type", "image/png");
+        res.body = *tile;
+        res.compressed = false; // png data is already compressed
+        return res;
+    }
+
+    crow::response road_tile_response(const crow::request &req, const RoadTileIndex &roadTiles,
+                                      TileCache &roadTileCache, const std::string &graphVersion, const int z,
+                                      const int x, const std::string &yFile) {
+        int y = -1;
+        if (!parse_tile_y(yFile, ".pbf", y) || !Raster::isValidTile(z, x, y))
+            return json_error_response(400, std::vformat(ERROR_INVALID_TILE, std::make_format_args(z, x, yFile)));
+
+        crow::response res;
+        res.set_header("ETag", graphVersion);
+        res.set_header("Cache-Control", "no-cache");
+        if (req.get_header_value("If-None-Match") == graphVersion) {
+            res.code = 304;
+            return res;
+        }
+
+        const auto key = get_road_tile_key(graphVersion, z, x, y);
+        auto tile = roadTileCache.Get(key);
+        if (!tile) {
+            // empty tiles get cached as well, most tiles around the graph contain no roads
+            auto pbf = roadTiles.RenderTile(z, x, y);
+            roadTileCache.Put(key, pbf);
+            tile = std::make_shared<const std::string>(std::move(pbf));
+        }
+
+        if (tile->empty()) {
+            res.code = 204;
+            return res;
+        }
+        res.set_header("Content-Type", "application/vnd.mapbox-vector-tile");
+        res.body = *tile;
+        return res;
+    }
+
+    std::string get_road_tile_key(const std::string &graphVersion, const int z, const int x, const int y) {
+        // tiles of a previous graph stay in the cache until they get evicted, but can't be hit anymore
+        return std::format("{}/{}/{}/{}", graphVersion, z, x, y);
+    }
+
+    std::string get_file_version(const std::string &filePath) {
+        // size and modification time identify a graph or raster file well enough without hashing gigabytes of data
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(filePath, ec);
+        const auto writeTime = std::filesystem::last_write_time(filePath, ec).time_since_epoch().count();
+        return std::format("\"{:x}-{:x}\"", size, writeTime);
+    }
+
+    crow::response static_file_response(const crow::request &req, const std::string &filePath) {
+        // never serve files outside the static folder
+        if (filePath.find("..") != std::string::npos)
+            return crow::response(404);
+
+        const std::filesystem::path path = std::filesystem::path(STATIC_FILE_DIRECTORY) / filePath;
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec))
+            return crow::response(404);
+
+        auto compressedPath = path;
+        compressedPath += ".gz";
+        const bool serveCompressed = req.get_header_value("Accept-Encoding").find("gzip") != std::string::npos &&
+                                     std::filesystem::exists(compressedPath, ec);
+
+        // static files only change with a new build, so the version of the file identifies them, the compressed
+        // variant needs its own etag as it has different bytes
+        auto etag = get_file_version(path.string());
+        if (serveCompressed) {
+            etag.insert(etag.size() - 1, "-gz"); // inside the quotes
+        }
+
+        crow::response res;
+        res.set_header("ETag", etag);
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Vary", "Accept-Encoding");
+        if (req.get_header_value("If-None-Match") == etag) {
+            res.code = 304;
+            return res;
+        }
+
+        if (!serveCompressed) {
+            res.set_static_file_info(path.string());
+            return res;
+        }
+
+        std::ifstream file(compressedPath, std::ios::binary);
+        res.body.assign(std::istreambuf_iterator(file), {});
+        res.compressed = false; // already compressed, crow must not compress it again
+        res.set_header("Content-Encoding", "gzip");
+        if (const auto extension = path.extension().string(); extension.size() > 1) {
+            const auto mimeType = crow::mime_types.find(extension.substr(1));
+            res.set_header("Content-Type", mimeType == crow::mime_types.end() ? "text/plain" : mimeType->second);
+        }
+        return res;
+    }
+
+    std::string BasicWebApp::impl::RenderMetrics(const TrackJobQueue &jobQueue) const {
+        PrometheusWriter out;
+
+        out.Metric("trackmapper_http_request_duration_seconds", "histogram", "Latency of the handled requests");
+        for (int route = 0; route <= Metrics::OTHER_ROUTE; ++route) {
+            const auto &routeMetrics = mMetrics.GetRouteMetrics(route);
+            if (routeMetrics.latencyUs.GetCount() == 0)
+                continue;
+            const auto labels = std::format("route=\"{}\"", Metrics::GetRouteName(route));
+            out.HistogramSamples(labels, routeMetrics.latencyUs, 1e-6);
+        }
+        out.Metric("trackmapper_http_request_errors_total", "counter", "Requests answered with a status of 400+");
+        for (int route = 0; route <= Metrics::OTHER_ROUTE; ++route) {
+            const auto &routeMetrics = mMetrics.GetRouteMetrics(route);
+            if (routeMetrics.latencyUs.GetCount() == 0)
+                continue;
+            const auto labels = std::format("route=\"{}\"", Metrics::GetRouteName(route));
+            out.Sample(labels, static_cast<double>(routeMetrics.errors.load(std::memory_order_relaxed)));
+        }
+
+        out.Metric("trackmapper_cache_hits_total", "counter", "Lookups answered from a cache");
+        out.Sample("cache=\"etag\"", static_cast<double>(mMetrics.etagCache.hits.load(std::memory_order_relaxed)));
+        out.Sample("cache=\"raster_metadata\"", static_cast<double>(mRasterCache.GetHitCount()));
+        out.Sample("cache=\"tile_memory\"", static_cast<double>(mTileCache.GetMemoryCounters().hits.load()));
+        out.Sample("cache=\"tile_disk\"", static_cast<double>(mTileCache.GetDiskCounters().hits.load()));
+        out.Sample("cache=\"road_tiles\"", static_cast<double>(mRoadTileCache.GetMemoryCounters().hits.load()));
+        out.Sample("cache=\"routes\"", static_cast<double>(mRouteCache.GetCounters().hits.load()));
+        out.Metric("trackmapper_cache_misses_total", "counter", "Lookups not answered from a cache");
+        out.Sample("cache=\"etag\"", static_cast<double>(mMetrics.etagCache.misses.load(std::memory_order_relaxed)));
+        out.Sample("cache=\"raster_metadata\"", static_cast<double>(mRasterCache.GetMissCount()));
+        out.Sample("cache=\"tile_memory\"", static_cast<double>(mTileCache.GetMemoryCounters().misses.load()));
+        out.Sample("cache=\"tile_disk\"", static_cast<double>(mTileCache.GetDiskCounters().misses.load()));
+        out.Sample("cache=\"road_tiles\"", static_cast<double>(mRoadTileCache.GetMemoryCounters().misses.load()));
+        out.Sample("cache=\"routes\"", static_cast<double>(mRouteCache.GetCounters().misses.load()));
+
+        const auto graph = GetGraph();
+        out.Metric("trackmapper_graph_nodes", "gauge", "Number of nodes of the loaded graph");
+        out.Sample("", graph->graph.GetNodeCount());
+        out.Metric("trackmapper_graph_edges", "gauge", "Number of edges of the loaded graph");
+        out.Sample("", graph->graph.GetEdgeCount());
+        out.Metric("trackmapper_graph_memory_bytes", "gauge", "Memory used by the node and edge arrays of the graph");
+        out.Sample("", static_cast<double>(graph->graph.GetMemoryUsage()));
+        out.Metric("trackmapper_graph_reloads_total", "counter", "Graphs loaded while the web app was running");
+        out.Sample("", static_cast<double>(mMetrics.graphReloads.load(std::memory_order_relaxed)));
+        out.Metric("trackmapper_huge_page_memory_bytes", "gauge", "Memory of the graph arrays backed by huge pages");
+        out.Sample("", static_cast<double>(GetHugePageBytes()));
+        if (const auto residentMemory = get_resident_memory(); residentMemory > 0) {
+            out.Metric("trackmapper_resident_memory_bytes", "gauge", "Resident memory of the whole process");
+            out.Sample("", static_cast<double>(residentMemory));
+        }
+
+        out.Metric("trackmapper_track_jobs", "gauge", "Track jobs currently waiting or being created");
+        out.Sample("state=\"running\"", jobQueue.GetRunningJobCount());
+        out.Sample("state=\"pending\"", jobQueue.GetPendingJobCount());
+        out.Metric("trackmapper_track_jobs_completed_total", "counter", "Track jobs that finished or failed");
+        out.Sample("result=\"finished\"", static_cast<double>(mMetrics.finishedJobs.load(std::memory_order_relaxed)));
+        out.Sample("result=\"failed\"", static_cast<double>(mMetrics.failedJobs.load(std::memory_order_relaxed)));
+        out.Metric("trackmapper_track_stage_duration_seconds", "histogram", "Time spent in each track creation stage");
+        for (int stage = 0; stage < Metrics::STAGES.size(); ++stage) {
+            const auto labels = std::format("stage=\"{}\"", Metrics::STAGES[stage]);
+            out.HistogramSamples(labels, mMetrics.stageDurationMs[stage], 1e-3);
+        }
+
+        out.Metric("trackmapper_path_search_settled_nodes", "histogram", "Nodes settled per path query");
+        out.HistogramSamples("", mSearchStats.settledNodes, 1);
+        out.Metric("trackmapper_path_search_duration_seconds", "histogram", "Duration of the path queries");
+        out.HistogramSamples("", mSearchStats.totalTimeUs, 1e-6);
+
+        return out.Get();
+    }
+
+    size_t get_resident_memory() {
+#ifdef __linux__
+        // second value is the number of resident pages
+        std::ifstream statm("/proc/self/statm");
+        size_t totalPages = 0;
+        size_t residentPages = 0;
+        statm >> totalPages >> residentPages;
+        return residentPages * sysconf(_SC_PAGESIZE);
+#else
+        return 0;
+#endif
+    }
+
+    void write_search_stats(JsonWriter &json, const SearchStats &stats) {
+        json.BeginObject();
+        json.Key("settledNodes").Int(stats.settledNodes);
+        json.Key("relaxedEdges").Int(stats.relaxedEdges);
+        json.Key("heapPushes").Int(stats.heapPushes);
+        json.Key("heapPops").Int(stats.heapPops);
+        json.Key("resetTimeUs").Int(std::chrono::duration_cast<std::chrono::microseconds>(stats.resetTime).count());
+        json.Key("totalTimeUs").Int(std::chrono::duration_cast<std::chrono::microseconds>(stats.totalTime).count());
+        json.EndObject();
+    }
+
+    crow::json::wvalue histogram_to_json(const Histogram &histogram) {
+        // only lists non empty buckets, each with its inclusive upper bound
+        std::vector<crow::json::wvalue> buckets;
+        for (int i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+            const auto count = histogram.GetBucketCount(i);
+            if (count == 0)
+                continue;
+
+            crow::json::wvalue bucket;
+            bucket["le"] = i == Histogram::BUCKET_COUNT - 1 ? "+Inf" : std::to_string(1ull << i);
+            bucket["count"] = count;
+            buckets.push_back(std::move(bucket));
+        }
+
+        crow::json::wvalue x;
+        x["count"] = histogram.GetCount();
+        x["sum"] = histogram.GetSum();
+        x["buckets"] = std::move(buckets);
+        return x;
     }
 
 } // namespace TrackMapper::Web
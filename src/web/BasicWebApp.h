@@ -7,16 +7,31 @@
 
 #include <string>
 
-#include "TrackData.h"
+#include "TrackJobQueue.h"
 
 namespace TrackMapper::Web {
     class BasicWebApp {
     public:
         explicit BasicWebApp(const std::string &filePath);
         ~BasicWebApp();
-        void Start(TrackData &trackData) const;
+        void Start(TrackJobQueue &jobQueue) const;
         void Stop() const;
 
+        /**
+         * Fills the track data from a json description of the track, in the same format as the web ui submits it
+         * @note Meant for creating tracks without the web ui, waypoints can be given as node id or as lat/lon
+         * @return error msg, empty if the description is valid
+         */
+        [[nodiscard]] std::string ReadTrackJob(const std::string &json, TrackData &data) const;
+
+        /**
+         * Fills the paths of the track with the shortest paths between its waypoint nodes
+         * @note Meant to run inside of the track job, most paths are cached from adding the waypoints in the browser
+         * @return false if the track got cancelled or the graph got reloaded since the track was submitted, the error
+         * is set in the latter case
+         */
+        bool ResolvePaths(TrackData &data) const;
+
     private:
         // opaque pointer to avoid linking against crow when including this header
         struct impl;
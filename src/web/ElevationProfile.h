@@ -0,0 +1,109 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef ELEVATION_PROFILE_H
+#define ELEVATION_PROFILE_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../graph/GeoUtils.h"
+#include "../mesh/raster_reader.h"
+
+namespace TrackMapper::Web {
+    constexpr int MAX_PROFILE_SAMPLES = 10000; // longer paths get sampled with a bigger spacing
+    constexpr double MIN_PROFILE_SPACING = 1; // meters, about the resolution of detailed height rasters
+
+    /// Summary of the heights along a path, heights without a value get skipped
+    struct ProfileStats {
+        float minHeight = NAN, maxHeight = NAN;
+        double ascent = 0, descent = 0; // summed up height differences between neighbouring samples
+    };
+
+    inline double path_length(const std::vector<Raster::OSMPoint> &path) {
+        double length = 0;
+        for (size_t i = 1; i < path.size(); ++i) {
+            length += haversineDistance({path[i - 1].lat, path[i - 1].lng}, {path[i].lat, path[i].lng});
+        }
+        return length;
+    }
+
+    /**
+     * Places points along the path with a fixed distance between them
+     * @return points starting at the first point of the path, the last one is the end of the path and can be closer
+     * to its predecessor
+     * @note Interpolates linearly in lat/lng between the points of the path, which is exact enough for the short
+     * distances between nodes of the graph
+     */
+    inline std::vector<Raster::OSMPoint> resample_path(const std::vector<Raster::OSMPoint> &path,
+                                                       const double spacing) {
+        std::vector<Raster::OSMPoint> samples;
+        if (path.empty())
+            return samples;
+
+        samples.push_back(path[0]);
+        double nextDistance = spacing; // distance of the next sample from the start of the current segment
+        for (size_t i = 1; i < path.size(); ++i) {
+            const auto &from = path[i - 1];
+            const auto &to = path[i];
+            const double length = haversineDistance({from.lat, from.lng}, {to.lat, to.lng});
+            for (; nextDistance < length; nextDistance += spacing) {
+                const double t = nextDistance / length;
+                samples.push_back({from.lat + (to.lat - from.lat) * t, from.lng + (to.lng - from.lng) * t});
+            }
+            nextDistance -= length;
+        }
+
+        // the end of the path always gets a sample, unless the path has no length and the start already is the end
+        if (nextDistance < spacing) {
+            samples.push_back(path.back());
+        }
+        return samples;
+    }
+
+    /// @return whether any sample without a height lies within the bounding box of the raster extends
+    inline bool has_missing_heights_in(const std::vector<Raster::OSMPoint> &samples, const std::vector<float> &heights,
+                                       const std::vector<Raster::OSMPoint> &extends) {
+        double minLat = INFINITY, maxLat = -INFINITY, minLng = INFINITY, maxLng = -INFINITY;
+        for (const auto [lat, lng]: extends) {
+            minLat = std::min(minLat, lat);
+            maxLat = std::max(maxLat, lat);
+            minLng = std::min(minLng, lng);
+            maxLng = std::max(maxLng, lng);
+        }
+
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const auto [lat, lng] = samples[i];
+            if (std::isnan(heights[i]) && lat >= minLat && lat <= maxLat && lng >= minLng && lng <= maxLng)
+                return true;
+        }
+        return false;
+    }
+
+    inline ProfileStats get_profile_stats(const std::vector<float> &heights) {
+        ProfileStats stats;
+        float prevHeight = NAN;
+        for (const float height: heights) {
+            if (std::isnan(height))
+                continue;
+
+            // NaN comparisons are false, so the first valid height always gets taken
+            if (!(height >= stats.minHeight)) {
+                stats.minHeight = height;
+            }
+            if (!(height <= stats.maxHeight)) {
+                stats.maxHeight = height;
+            }
+            if (!std::isnan(prevHeight)) {
+                const double delta = height - prevHeight;
+                (delta > 0 ? stats.ascent : stats.descent) += std::abs(delta);
+            }
+            prevHeight = height;
+        }
+        return stats;
+    }
+} // namespace TrackMapper::Web
+
+#endif // ELEVATION_PROFILE_H
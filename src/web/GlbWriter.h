@@ -0,0 +1,207 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef GLB_WRITER_H
+#define GLB_WRITER_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "JsonWriter.h"
+
+namespace TrackMapper::Web {
+    /// Triangle mesh with a single color, in the coordinate system of gltf (y up, right-handed, meters)
+    struct GlbMesh {
+        std::string name;
+        std::vector<float> positions; // x, y, z of each vertex
+        std::vector<float> normals; // x, y, z of each vertex, same count as positions
+        std::vector<uint32_t> indices; // three per triangle, counter-clockwise when seen from the front
+        std::array<float, 4> color{1, 1, 1, 1}; // linear rgba
+    };
+
+    /// Sets the normal of every vertex to the normalized sum of the normals of its triangles
+    inline void compute_normals(GlbMesh &mesh) {
+        mesh.normals.assign(mesh.positions.size(), 0);
+        const auto &p = mesh.positions;
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            const uint32_t a = mesh.indices[i] * 3, b = mesh.indices[i + 1] * 3, c = mesh.indices[i + 2] * 3;
+            const float e1x = p[b] - p[a], e1y = p[b + 1] - p[a + 1], e1z = p[b + 2] - p[a + 2];
+            const float e2x = p[c] - p[a], e2y = p[c + 1] - p[a + 1], e2z = p[c + 2] - p[a + 2];
+            // not normalized, so bigger triangles weigh more
+            const float nx = e1y * e2z - e1z * e2y, ny = e1z * e2x - e1x * e2z, nz = e1x * e2y - e1y * e2x;
+            for (const uint32_t v: {a, b, c}) {
+                mesh.normals[v] += nx;
+                mesh.normals[v + 1] += ny;
+                mesh.normals[v + 2] += nz;
+            }
+        }
+        for (size_t v = 0; v + 2 < mesh.normals.size(); v += 3) {
+            const float length = std::hypot(mesh.normals[v], mesh.normals[v + 1], mesh.normals[v + 2]);
+            if (length > 0) {
+                mesh.normals[v] /= length;
+                mesh.normals[v + 1] /= length;
+                mesh.normals[v + 2] /= length;
+            } else {
+                mesh.normals[v + 1] = 1; // vertices without triangles
+            }
+        }
+    }
+
+    /**
+     * Encodes the meshes as a binary gltf 2.0 file with one node per mesh, meshes without triangles get skipped
+     * @see https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#binary-gltf-layout
+     */
+    inline std::string encode_glb(const std::vector<GlbMesh> &meshes) {
+        static_assert(std::endian::native == std::endian::little, "glb stores all values in little endian");
+
+        constexpr uint32_t GLB_MAGIC = 0x46546C67; // "glTF"
+        constexpr uint32_t CHUNK_JSON = 0x4E4F534A;
+        constexpr uint32_t CHUNK_BIN = 0x004E4942;
+        constexpr int COMPONENT_FLOAT = 5126;
+        constexpr int COMPONENT_UINT = 5125;
+        constexpr int TARGET_ARRAY_BUFFER = 34962;
+        constexpr int TARGET_ELEMENT_ARRAY_BUFFER = 34963;
+
+        // all values are 4 bytes wide, so every buffer view stays 4 byte aligned without padding
+        std::string bin;
+        JsonWriter views(1024), accessors(1024), meshList(1024), materials(512), nodes(256);
+        views.BeginArray();
+        accessors.BeginArray();
+        meshList.BeginArray();
+        materials.BeginArray();
+        nodes.BeginArray();
+
+        int viewCount = 0, meshCount = 0;
+        const auto addView = [&](const void *data, const size_t bytes, const int target) {
+            views.BeginObject();
+            views.Key("buffer").Int(0);
+            views.Key("byteOffset").Int(static_cast<int64_t>(bin.size()));
+            views.Key("byteLength").Int(static_cast<int64_t>(bytes));
+            views.Key("target").Int(target);
+            views.EndObject();
+            bin.append(static_cast<const char *>(data), bytes);
+            return viewCount++;
+        };
+
+        for (const auto &mesh: meshes) {
+            if (mesh.indices.empty())
+                continue;
+
+            const auto vertexCount = static_cast<int64_t>(mesh.positions.size() / 3);
+            std::array<float, 3> min{INFINITY, INFINITY, INFINITY}, max{-INFINITY, -INFINITY, -INFINITY};
+            for (size_t i = 0; i < mesh.positions.size(); ++i) {
+                min[i % 3] = std::min(min[i % 3], mesh.positions[i]);
+                max[i % 3] = std::max(max[i % 3], mesh.positions[i]);
+            }
+
+            // accessors: position, normal, indices
+            const int firstAccessor = meshCount * 3;
+            const int positionView = addView(mesh.positions.data(), mesh.positions.size() * sizeof(float),
+                                             TARGET_ARRAY_BUFFER);
+            const int normalView = addView(mesh.normals.data(), mesh.normals.size() * sizeof(float),
+                                           TARGET_ARRAY_BUFFER);
+            const int indexView = addView(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t),
+                                          TARGET_ELEMENT_ARRAY_BUFFER);
+
+            accessors.BeginObject();
+            accessors.Key("bufferView").Int(positionView);
+            accessors.Key("componentType").Int(COMPONENT_FLOAT);
+            accessors.Key("count").Int(vertexCount);
+            accessors.Key("type").String("VEC3");
+            accessors.Key("min").BeginArray().Double(min[0]).Double(min[1]).Double(min[2]).EndArray();
+            accessors.Key("max").BeginArray().Double(max[0]).Double(max[1]).Double(max[2]).EndArray();
+            accessors.EndObject();
+            accessors.BeginObject();
+            accessors.Key("bufferView").Int(normalView);
+            accessors.Key("componentType").Int(COMPONENT_FLOAT);
+            accessors.Key("count").Int(vertexCount);
+            accessors.Key("type").String("VEC3");
+            accessors.EndObject();
+            accessors.BeginObject();
+            accessors.Key("bufferView").Int(indexView);
+            accessors.Key("componentType").Int(COMPONENT_UINT);
+            accessors.Key("count").Int(static_cast<int64_t>(mesh.indices.size()));
+            accessors.Key("type").String("SCALAR");
+            accessors.EndObject();
+
+            materials.BeginObject();
+            materials.Key("name").String(mesh.name);
+            materials.Key("pbrMetallicRoughness").BeginObject();
+            materials.Key("baseColorFactor").BeginArray();
+            for (const float c: mesh.color) {
+                materials.Double(c);
+            }
+            materials.EndArray();
+            materials.Key("metallicFactor").Int(0);
+            materials.Key("roughnessFactor").Int(1);
+            materials.EndObject();
+            materials.EndObject();
+
+            meshList.BeginObject();
+            meshList.Key("name").String(mesh.name);
+            meshList.Key("primitives").BeginArray().BeginObject();
+            meshList.Key("attributes").BeginObject();
+            meshList.Key("POSITION").Int(firstAccessor);
+            meshList.Key("NORMAL").Int(firstAccessor + 1);
+            meshList.EndObject();
+            meshList.Key("indices").Int(firstAccessor + 2);
+            meshList.Key("material").Int(meshCount);
+            meshList.EndObject().EndArray();
+            meshList.EndObject();
+
+            nodes.BeginObject();
+            nodes.Key("name").String(mesh.name);
+            nodes.Key("mesh").Int(meshCount);
+            nodes.EndObject();
+
+            ++meshCount;
+        }
+        views.EndArray();
+        accessors.EndArray();
+        meshList.EndArray();
+        materials.EndArray();
+        nodes.EndArray();
+
+        std::string json = R"({"asset":{"version":"2.0","generator":"TrackMapper"},"scene":0,"scenes":[{"nodes":[)";
+        for (int i = 0; i < meshCount; ++i) {
+            json.append(i == 0 ? "" : ",").append(std::to_string(i));
+        }
+        json.append("]}],\"nodes\":").append(nodes.Take());
+        json.append(",\"meshes\":").append(meshList.Take());
+        json.append(",\"materials\":").append(materials.Take());
+        json.append(",\"accessors\":").append(accessors.Take());
+        json.append(",\"bufferViews\":").append(views.Take());
+        json.append(",\"buffers\":[{\"byteLength\":").append(std::to_string(bin.size())).append("}]}");
+
+        // chunks have to be 4 byte aligned, json gets padded with spaces and binary data with zeros
+        json.resize((json.size() + 3) & ~size_t{3}, ' ');
+        bin.resize((bin.size() + 3) & ~size_t{3}, '\0');
+
+        std::string glb;
+        glb.reserve(12 + 8 + json.size() + 8 + bin.size());
+        const auto appendUint = [&glb](const uint32_t value) {
+            char bytes[4];
+            std::memcpy(bytes, &value, sizeof(bytes));
+            glb.append(bytes, sizeof(bytes));
+        };
+        appendUint(GLB_MAGIC);
+        appendUint(2);
+        appendUint(static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+        appendUint(static_cast<uint32_t>(json.size()));
+        appendUint(CHUNK_JSON);
+        glb.append(json);
+        appendUint(static_cast<uint32_t>(bin.size()));
+        appendUint(CHUNK_BIN);
+        glb.append(bin);
+        return glb;
+    }
+} // namespace TrackMapper::Web
+
+#endif // GLB_WRITER_H
@@ -0,0 +1,50 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace TrackMapper::Web {
+    /// Histogram with power of two bucket bounds, recording is lock free so it can be used on hot paths from any thread
+    class Histogram {
+    public:
+        // bucket i counts values in (2^(i-1), 2^i], the last bucket also counts all bigger values
+        static constexpr int BUCKET_COUNT = 40;
+
+        void Record(const uint64_t value) {
+            const int bucket = value == 0 ? 0 : std::min(static_cast<int>(std::bit_width(value - 1)), BUCKET_COUNT - 1);
+            mBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            mCount.fetch_add(1, std::memory_order_relaxed);
+            mSum.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t GetCount() const { return mCount.load(std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t GetSum() const { return mSum.load(std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t GetBucketCount(const int bucket) const {
+            return mBuckets[bucket].load(std::memory_order_relaxed);
+        }
+
+        /// @return inclusive upper bound of the bucket, the last bucket is unbounded
+        [[nodiscard]] static double GetUpperBound(const int bucket) {
+            if (bucket == BUCKET_COUNT - 1)
+                return std::numeric_limits<double>::infinity();
+
+            return static_cast<double>(uint64_t{1} << bucket);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> mBuckets{};
+        std::atomic<uint64_t> mCount = 0;
+        std::atomic<uint64_t> mSum = 0;
+    };
+} // namespace TrackMapper::Web
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,126 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace TrackMapper::Web {
+    /// Writes json directly into a single string, without building a tree of values first like crow::json::wvalue
+    /// @note Places the commas by itself, the caller has to match every Begin with an End and write a key before
+    /// every value of an object
+    class JsonWriter {
+    public:
+        /// @param expectedSize bytes to reserve up front, a good estimate avoids all reallocations
+        explicit JsonWriter(const size_t expectedSize = 0) { mOut.reserve(expectedSize); }
+
+        JsonWriter &BeginObject() { return mOpen('{'); }
+        JsonWriter &EndObject() { return mClose('}'); }
+        JsonWriter &BeginArray() { return mOpen('['); }
+        JsonWriter &EndArray() { return mClose(']'); }
+
+        JsonWriter &Key(const std::string_view key) {
+            String(key);
+            mOut.push_back(':');
+            mNeedsComma = false;
+            return *this;
+        }
+
+        JsonWriter &String(const std::string_view value) {
+            mBeginValue();
+            mOut.push_back('"');
+            for (const char c: value) {
+                switch (c) {
+                    case '"':
+                        mOut.append("\\\"");
+                        break;
+                    case '\\':
+                        mOut.append("\\\\");
+                        break;
+                    case '\n':
+                        mOut.append("\\n");
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            constexpr char hex[] = "0123456789abcdef";
+                            mOut.append("\\u00");
+                            mOut.push_back(hex[c >> 4]);
+                            mOut.push_back(hex[c & 0xf]);
+                        } else {
+                            mOut.push_back(c);
+                        }
+                }
+            }
+            mOut.push_back('"');
+            return *this;
+        }
+
+        JsonWriter &Int(const int64_t value) {
+            mBeginValue();
+            char buffer[24];
+            const auto [end, _] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            mOut.append(buffer, end);
+            return *this;
+        }
+
+        /// Writes the shortest representation that reads back to the same value, NaN and infinity as null since json
+        /// can't represent them
+        JsonWriter &Double(const double value) {
+            if (!std::isfinite(value))
+                return Null();
+
+            mBeginValue();
+            char buffer[32];
+            const auto [end, _] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            mOut.append(buffer, end);
+            return *this;
+        }
+
+        JsonWriter &Bool(const bool value) {
+            mBeginValue();
+            mOut.append(value ? "true" : "false");
+            return *this;
+        }
+
+        JsonWriter &Null() {
+            mBeginValue();
+            mOut.append("null");
+            return *this;
+        }
+
+        /// @return the written json, the writer must not be used afterward
+        [[nodiscard]] std::string Take() { return std::move(mOut); }
+
+    private:
+        std::string mOut;
+        bool mNeedsComma = false; // false at the start of objects and arrays and right after keys
+
+        void mBeginValue() {
+            if (mNeedsComma) {
+                mOut.push_back(',');
+            }
+            mNeedsComma = true;
+        }
+
+        JsonWriter &mOpen(const char bracket) {
+            mBeginValue();
+            mOut.push_back(bracket);
+            mNeedsComma = false;
+            return *this;
+        }
+
+        JsonWriter &mClose(const char bracket) {
+            mOut.push_back(bracket);
+            mNeedsComma = true;
+            return *this;
+        }
+    };
+} // namespace TrackMapper::Web
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,78 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "Metrics.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace TrackMapper::Web {
+    int Metrics::FindRoute(const std::string_view url) {
+        for (int i = 0; i < ROUTES.size(); ++i) {
+            // matches whole path segments only, so '/api/get_node' does not count '/api/get_nodes_in_radius'
+            if (url.starts_with(ROUTES[i]) && (url.size() == ROUTES[i].size() || url[ROUTES[i].size()] == '/'))
+                return i;
+        }
+        return OTHER_ROUTE;
+    }
+
+    std::string_view Metrics::GetRouteName(const int route) { return route == OTHER_ROUTE ? "other" : ROUTES[route]; }
+
+    void Metrics::RecordRequest(const int route, const uint64_t latencyUs, const int statusCode) {
+        auto &metrics = mRoutes[route];
+        metrics.latencyUs.Record(latencyUs);
+        if (statusCode >= 400) {
+            metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const RouteMetrics &Metrics::GetRouteMetrics(const int route) const { return mRoutes[route]; }
+
+    void PrometheusWriter::Metric(const std::string_view name, const std::string_view type,
+                                  const std::string_view help) {
+        mName = name;
+        mOut.append("# HELP ").append(name).append(" ").append(help).append("\n");
+        mOut.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+    }
+
+    void PrometheusWriter::Sample(const std::string_view labels, const double value) {
+        mWriteSample("", labels, "", value);
+    }
+
+    void PrometheusWriter::HistogramSamples(const std::string_view labels, const Histogram &histogram,
+                                            const double scale) {
+        // prometheus buckets are cumulative
+        uint64_t count = 0;
+        for (int i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+            count += histogram.GetBucketCount(i);
+
+            std::string le = "le=\"+Inf\"";
+            if (i != Histogram::BUCKET_COUNT - 1) {
+                char buffer[32];
+                const double bound = Histogram::GetUpperBound(i) * scale;
+                const auto [end, _] = std::to_chars(buffer, buffer + sizeof(buffer), bound);
+                le = "le=\"" + std::string(buffer, end) + "\"";
+            }
+            mWriteSample("_bucket", labels, le, static_cast<double>(count));
+        }
+        mWriteSample("_sum", labels, "", static_cast<double>(histogram.GetSum()) * scale);
+        mWriteSample("_count", labels, "", static_cast<double>(histogram.GetCount()));
+    }
+
+    void PrometheusWriter::mWriteSample(const std::string_view suffix, const std::string_view labels,
+                                        const std::string_view extraLabel, const double value) {
+        mOut.append(mName).append(suffix);
+        if (!labels.empty() || !extraLabel.empty()) {
+            mOut.append("{").append(labels);
+            if (!labels.empty() && !extraLabel.empty()) {
+                mOut.append(",");
+            }
+            mOut.append(extraLabel).append("}");
+        }
+
+        char buffer[32];
+        const auto [end, _] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        mOut.append(" ").append(buffer, end).append("\n");
+    }
+} // namespace TrackMapper::Web
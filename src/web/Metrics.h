@@ -0,0 +1,93 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Histogram.h"
+
+namespace TrackMapper::Web {
+    /// Hit and miss counters of a cache, recording is lock free
+    struct CacheCounters {
+        std::atomic<uint64_t> hits = 0;
+        std::atomic<uint64_t> misses = 0;
+
+        void Record(const bool hit) { (hit ? hits : misses).fetch_add(1, std::memory_order_relaxed); }
+    };
+
+    /// Counters of all requests to a single route
+    struct RouteMetrics {
+        Histogram latencyUs; // its count is the number of requests
+        std::atomic<uint64_t> errors = 0; // responses with a status code of 400 or above
+    };
+
+    /// Collects the metrics of the web app, recording is lock free so it can happen on every request
+    class Metrics {
+    public:
+        // requests get assigned to a route by the start of their url, all other requests are counted as 'other'
+        static constexpr std::array<std::string_view, 20> ROUTES{
+                "/api/get_node",         "/api/get_nearest_nodes", "/api/get_nodes_in_radius",
+                "/api/get_location",     "/api/get_path",          "/api/snap_route",
+                "/api/get_search_stats", "/api/get_raster_extend", "/api/get_elevation_profile",
+                "/api/create_track",     "/api/cancel_track",      "/api/get_jobs",
+                "/api/get_progress",     "/api/progress_stream",   "/api/get_preview",
+                "/api/tiles/hillshade",  "/api/tiles/roads",       "/static",
+                "/metrics",              "/admin",
+        };
+        static constexpr int OTHER_ROUTE = ROUTES.size();
+
+        // stages of the track creation, matching the order of the progress events
+        static constexpr std::array<std::string_view, 4> STAGES{"terrain", "roads", "spawn", "export"};
+
+        /// @return index into ROUTES or OTHER_ROUTE
+        [[nodiscard]] static int FindRoute(std::string_view url);
+
+        [[nodiscard]] static std::string_view GetRouteName(int route);
+
+        void RecordRequest(int route, uint64_t latencyUs, int statusCode);
+
+        [[nodiscard]] const RouteMetrics &GetRouteMetrics(int route) const;
+
+        CacheCounters etagCache; // conditional requests answered with 304
+
+        std::array<Histogram, STAGES.size()> stageDurationMs;
+        std::atomic<uint64_t> finishedJobs = 0;
+        std::atomic<uint64_t> failedJobs = 0;
+        std::atomic<uint64_t> graphReloads = 0;
+
+    private:
+        std::array<RouteMetrics, ROUTES.size() + 1> mRoutes;
+    };
+
+    /// Writes metrics in the prometheus text exposition format
+    /// @see https://prometheus.io/docs/instrumenting/exposition_formats/
+    class PrometheusWriter {
+    public:
+        /// Starts a new metric, all following samples belong to it
+        void Metric(std::string_view name, std::string_view type, std::string_view help);
+
+        /// @param labels comma separated label pairs, e.g. route="/metrics"
+        void Sample(std::string_view labels, double value);
+
+        /// Writes buckets, sum and count of the histogram, its bucket bounds and values get multiplied by scale
+        void HistogramSamples(std::string_view labels, const Histogram &histogram, double scale);
+
+        [[nodiscard]] const std::string &Get() const { return mOut; }
+
+    private:
+        std::string mOut;
+        std::string mName;
+
+        void mWriteSample(std::string_view suffix, std::string_view labels, std::string_view extraLabel,
+                          double value);
+    };
+} // namespace TrackMapper::Web
+
+#endif // METRICS_H
@@ -0,0 +1,58 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef POLYLINE_H
+#define POLYLINE_H
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../graph/IGraph.h"
+
+namespace TrackMapper::Web {
+    /// Number of decimal places kept per coordinate, 6 keeps about 0.1m of detail
+    constexpr int POLYLINE_PRECISION = 6;
+
+    /// Appends a signed value in the encoded polyline format, 5 bits per printable character
+    inline void append_polyline_value(std::string &out, const int64_t value) {
+        // zigzag encoding puts the sign into the lowest bit
+        uint64_t bits = value < 0 ? ~(static_cast<uint64_t>(value) << 1) : static_cast<uint64_t>(value) << 1;
+        while (bits >= 0x20) {
+            out.push_back(static_cast<char>((0x20 | (bits & 0x1f)) + 63));
+            bits >>= 5;
+        }
+        out.push_back(static_cast<char>(bits + 63));
+    }
+
+    /**
+     * Encodes the locations of the nodes as delta coded polyline
+     * @see https://developers.google.com/maps/documentation/utilities/polylinealgorithm
+     * @note Uses a precision of POLYLINE_PRECISION instead of the usual 5 decimal places
+     */
+    inline std::string encode_polyline(const IGraph &graph, const std::vector<int> &nodeIds) {
+        constexpr double factor = 1e6;
+        static_assert(POLYLINE_PRECISION == 6, "factor has to match the precision");
+
+        std::string out;
+        out.reserve(nodeIds.size() * 8); // small deltas between neighbouring nodes take up to 4 chars per value
+
+        int64_t prevLat = 0;
+        int64_t prevLon = 0;
+        for (const auto nodeId: nodeIds) {
+            const auto [latitude, longitude] = graph.GetLocation(nodeId);
+            const auto lat = std::llround(latitude * factor);
+            const auto lon = std::llround(longitude * factor);
+
+            append_polyline_value(out, lat - prevLat);
+            append_polyline_value(out, lon - prevLon);
+            prevLat = lat;
+            prevLon = lon;
+        }
+        return out;
+    }
+} // namespace TrackMapper::Web
+
+#endif // POLYLINE_H
@@ -0,0 +1,287 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "RoadTileIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numbers>
+
+#include "VectorTile.h"
+
+namespace TrackMapper::Web {
+    constexpr double TILE_BUFFER = 64; // tile units added around each tile, so lines continue across tile borders
+    constexpr double SIMPLIFY_TOLERANCE = 8; // tile units, half a pixel on screen
+    constexpr double MAX_LATITUDE = 85.0511287798; // web mercator cuts off the poles here
+
+    static uint64_t getBucketKey(int x, int y);
+    static void simplifyLine(const std::vector<std::array<double, 2>> &line, std::vector<TilePoint> &out);
+
+    RoadTileIndex::RoadTileIndex(const IGraph &graph) {
+        const int nodeCount = graph.GetNodeCount();
+
+        // collects the neighbours of each node ignoring edge directions, as both directions of a road are one line
+        std::vector<int> offsets(nodeCount + 1, 0);
+        for (int node = 0; node < nodeCount; ++node) {
+            for (const auto [neighbour, _]: graph.GetEdges(node)) {
+                offsets[node + 1]++;
+                offsets[neighbour + 1]++;
+            }
+        }
+        for (int node = 0; node < nodeCount; ++node) {
+            offsets[node + 1] += offsets[node];
+        }
+
+        std::vector<int> neighbours(offsets[nodeCount]);
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        for (int node = 0; node < nodeCount; ++node) {
+            for (const auto [neighbour, _]: graph.GetEdges(node)) {
+                neighbours[fill[node]++] = neighbour;
+                neighbours[fill[neighbour]++] = node;
+            }
+        }
+
+        // removes duplicates from edges existing in both directions, the lists stay at their offsets
+        std::vector<int> degrees(nodeCount);
+        for (int node = 0; node < nodeCount; ++node) {
+            const auto begin = neighbours.begin() + offsets[node];
+            const auto end = neighbours.begin() + offsets[node + 1];
+            std::sort(begin, end);
+            degrees[node] = static_cast<int>(std::unique(begin, end) - begin);
+        }
+
+        std::vector<bool> visited(neighbours.size(), false);
+        const auto visit = [&](const int from, const int to) {
+            for (int slot = offsets[from]; slot < offsets[from] + degrees[from]; ++slot) {
+                if (neighbours[slot] == to)
+                    visited[slot] = true;
+            }
+            for (int slot = offsets[to]; slot < offsets[to] + degrees[to]; ++slot) {
+                if (neighbours[slot] == from)
+                    visited[slot] = true;
+            }
+        };
+
+        // follows the edges from the start until a node not having exactly 2 neighbours is reached
+        std::vector<int> chain;
+        const auto walkChain = [&](const int start, const int first) {
+            chain = {start, first};
+            visit(start, first);
+
+            int current = first;
+            while (degrees[current] == 2) {
+                int next = -1;
+                for (int slot = offsets[current]; slot < offsets[current] + 2; ++slot) {
+                    if (!visited[slot]) {
+                        next = neighbours[slot];
+                        break;
+                    }
+                }
+                if (next == -1)
+                    break; // closed a cycle
+
+                visit(current, next);
+                chain.push_back(next);
+                current = next;
+            }
+            mAddChain(graph, chain);
+        };
+
+        mChainOffsets.push_back(0);
+        for (int node = 0; node < nodeCount; ++node) {
+            if (degrees[node] == 2)
+                continue;
+            for (int slot = offsets[node]; slot < offsets[node] + degrees[node]; ++slot) {
+                if (!visited[slot]) {
+                    walkChain(node, neighbours[slot]);
+                }
+            }
+        }
+        // only cycles made of nodes with 2 neighbours are left
+        for (int node = 0; node < nodeCount; ++node) {
+            for (int slot = offsets[node]; slot < offsets[node] + degrees[node]; ++slot) {
+                if (!visited[slot]) {
+                    walkChain(node, neighbours[slot]);
+                }
+            }
+        }
+    }
+
+    std::string RoadTileIndex::RenderTile(const int z, const int x, const int y) const {
+        if (z < MIN_ZOOM)
+            return "";
+
+        const double scale = std::ldexp(1.0, z);
+        const double buffer = TILE_BUFFER / MVT_EXTENT;
+        const BoundingBox tileBounds{{(x - buffer) / scale, (y - buffer) / scale},
+                                     {(x + 1 + buffer) / scale, (y + 1 + buffer) / scale}};
+        const auto overlaps = [&tileBounds](const MapPoint min, const MapPoint max) {
+            return min.x <= tileBounds.max.x && max.x >= tileBounds.min.x && min.y <= tileBounds.max.y &&
+                   max.y >= tileBounds.min.y;
+        };
+
+        // collects the chains of all buckets overlapping the tile
+        constexpr int bucketCount = 1 << INDEX_ZOOM;
+        const auto toBucket = [](const double value) {
+            return std::clamp(static_cast<int>(value * bucketCount), 0, bucketCount - 1);
+        };
+        std::vector<int> chains;
+        for (int bucketX = toBucket(tileBounds.min.x); bucketX <= toBucket(tileBounds.max.x); ++bucketX) {
+            for (int bucketY = toBucket(tileBounds.min.y); bucketY <= toBucket(tileBounds.max.y); ++bucketY) {
+                if (const auto it = mBuckets.find(getBucketKey(bucketX, bucketY)); it != mBuckets.end()) {
+                    chains.insert(chains.end(), it->second.begin(), it->second.end());
+                }
+            }
+        }
+        std::ranges::sort(chains);
+        chains.erase(std::ranges::unique(chains).begin(), chains.end());
+
+        std::vector<std::vector<TilePoint>> lines;
+        std::vector<std::array<double, 2>> part;
+        const auto finishPart = [&lines, &part] {
+            if (part.size() >= 2) {
+                std::vector<TilePoint> line;
+                simplifyLine(part, line);
+                if (line.size() >= 2) {
+                    lines.push_back(std::move(line));
+                }
+            }
+            part.clear();
+        };
+        const auto toTile = [scale, x, y](const MapPoint point) {
+            return std::array{(point.x * scale - x) * MVT_EXTENT, (point.y * scale - y) * MVT_EXTENT};
+        };
+
+        for (const auto chain: chains) {
+            if (const auto [min, max] = mChainBounds[chain]; !overlaps(min, max))
+                continue;
+
+            // only keeps the parts of the chain inside the tile, long roads would otherwise end up in every tile
+            for (int i = mChainOffsets[chain]; i < mChainOffsets[chain + 1] - 1; ++i) {
+                const auto from = mPoints[i];
+                const auto to = mPoints[i + 1];
+                const MapPoint min{std::min(from.x, to.x), std::min(from.y, to.y)};
+                const MapPoint max{std::max(from.x, to.x), std::max(from.y, to.y)};
+                if (!overlaps(min, max)) {
+                    finishPart();
+                    continue;
+                }
+
+                if (part.empty()) {
+                    part.push_back(toTile(from));
+                }
+                part.push_back(toTile(to));
+            }
+            finishPart();
+        }
+
+        if (lines.empty())
+            return "";
+        return encode_line_tile("roads", lines);
+    }
+
+    std::vector<std::array<int, 2>> RoadTileIndex::GetMinZoomTiles() const {
+        constexpr int shift = INDEX_ZOOM - MIN_ZOOM;
+        std::map<std::array<int, 2>, size_t> chainCounts;
+        for (const auto &[key, chains]: mBuckets) {
+            const int x = static_cast<int>(key >> 32);
+            const int y = static_cast<int>(key & 0xffffffff);
+            chainCounts[{x >> shift, y >> shift}] += chains.size();
+        }
+
+        std::vector<std::pair<size_t, std::array<int, 2>>> sorted;
+        for (const auto &[tile, count]: chainCounts) {
+            sorted.emplace_back(count, tile);
+        }
+        std::ranges::sort(sorted, std::greater());
+
+        std::vector<std::array<int, 2>> tiles;
+        for (const auto &[_, tile]: sorted) {
+            tiles.push_back(tile);
+        }
+        return tiles;
+    }
+
+    void RoadTileIndex::mAddChain(const IGraph &graph, const std::vector<int> &nodeIds) {
+        BoundingBox bounds{{1, 1}, {0, 0}};
+        for (const auto nodeId: nodeIds) {
+            // see: https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames [2026-10-19]
+            const auto [latitude, longitude] = graph.GetLocation(nodeId);
+            const double lat = std::clamp(latitude, -MAX_LATITUDE, MAX_LATITUDE) * std::numbers::pi / 180;
+            const MapPoint point{(longitude + 180) / 360,
+                                 (1 - std::log(std::tan(lat) + 1 / std::cos(lat)) / std::numbers::pi) / 2};
+            mPoints.push_back(point);
+
+            bounds.min = {std::min(bounds.min.x, point.x), std::min(bounds.min.y, point.y)};
+            bounds.max = {std::max(bounds.max.x, point.x), std::max(bounds.max.y, point.y)};
+        }
+
+        const int chain = static_cast<int>(mChainBounds.size());
+        mChainOffsets.push_back(static_cast<int>(mPoints.size()));
+        mChainBounds.push_back(bounds);
+
+        constexpr int bucketCount = 1 << INDEX_ZOOM;
+        const auto toBucket = [](const double value) {
+            return std::clamp(static_cast<int>(value * bucketCount), 0, bucketCount - 1);
+        };
+        for (int bucketX = toBucket(bounds.min.x); bucketX <= toBucket(bounds.max.x); ++bucketX) {
+            for (int bucketY = toBucket(bounds.min.y); bucketY <= toBucket(bounds.max.y); ++bucketY) {
+                mBuckets[getBucketKey(bucketX, bucketY)].push_back(chain);
+            }
+        }
+    }
+
+    static uint64_t getBucketKey(const int x, const int y) {
+        return static_cast<uint64_t>(x) << 32 | static_cast<uint32_t>(y);
+    }
+
+    static void simplifyLine(const std::vector<std::array<double, 2>> &line, std::vector<TilePoint> &out) {
+        // Douglas-Peucker: keeps the point furthest from the line between the kept ends, until all are close enough
+        std::vector<bool> keep(line.size(), false);
+        keep.front() = keep.back() = true;
+
+        std::vector<std::pair<size_t, size_t>> stack{{0, line.size() - 1}};
+        while (!stack.empty()) {
+            const auto [first, last] = stack.back();
+            stack.pop_back();
+
+            const auto [ax, ay] = line[first];
+            const auto [bx, by] = line[last];
+            const double dx = bx - ax;
+            const double dy = by - ay;
+            const double length = std::sqrt(dx * dx + dy * dy);
+
+            double maxDistance = 0;
+            size_t furthest = first;
+            for (size_t i = first + 1; i < last; ++i) {
+                const auto [px, py] = line[i];
+                // distance to the line, or to the first point if both ends are at the same position
+                const double distance = length > 0 ? std::abs(dx * (ay - py) - dy * (ax - px)) / length
+                                                   : std::hypot(px - ax, py - ay);
+                if (distance > maxDistance) {
+                    maxDistance = distance;
+                    furthest = i;
+                }
+            }
+
+            if (maxDistance > SIMPLIFY_TOLERANCE) {
+                keep[furthest] = true;
+                stack.emplace_back(first, furthest);
+                stack.emplace_back(furthest, last);
+            }
+        }
+
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (!keep[i])
+                continue;
+
+            const TilePoint point{static_cast<int32_t>(std::lround(line[i][0])),
+                                  static_cast<int32_t>(std::lround(line[i][1]))};
+            if (out.empty() || out.back() != point) {
+                out.push_back(point);
+            }
+        }
+    }
+} // namespace TrackMapper::Web
@@ -0,0 +1,58 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef ROADTILEINDEX_H
+#define ROADTILEINDEX_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../graph/IGraph.h"
+
+namespace TrackMapper::Web {
+    /// Renders the edges of a graph as vector tiles
+    /// @note Edges between nodes with exactly 2 neighbours get joined into chains, so roads become single lines
+    class RoadTileIndex {
+    public:
+        // below this zoom level the roads are too dense to be useful and the tiles get too big
+        static constexpr int MIN_ZOOM = 10;
+        // zoom level of the tiles used as buckets of the spatial index
+        static constexpr int INDEX_ZOOM = 12;
+
+        explicit RoadTileIndex(const IGraph &graph);
+
+        /**
+         * Renders the roads of a tile, simplified to the detail visible at its zoom level
+         * @return encoded vector tile, empty if no roads are in the tile or the zoom level is below MIN_ZOOM
+         */
+        [[nodiscard]] std::string RenderTile(int z, int x, int y) const;
+
+        /// @return coordinates of all tiles at MIN_ZOOM containing roads, ordered by number of roads, most first
+        [[nodiscard]] std::vector<std::array<int, 2>> GetMinZoomTiles() const;
+
+        [[nodiscard]] size_t GetChainCount() const { return mChainOffsets.size() - 1; }
+
+    private:
+        /// Position in normalized web mercator coordinates, (0, 0) is the top left and (1, 1) the bottom right corner
+        struct MapPoint {
+            double x, y;
+        };
+        struct BoundingBox {
+            MapPoint min, max;
+        };
+
+        // points of chain i are mPoints[mChainOffsets[i]] to mPoints[mChainOffsets[i + 1] - 1]
+        std::vector<int> mChainOffsets;
+        std::vector<MapPoint> mPoints;
+        std::vector<BoundingBox> mChainBounds;
+        std::unordered_map<uint64_t, std::vector<int>> mBuckets; // chains overlapping each tile at INDEX_ZOOM
+
+        void mAddChain(const IGraph &graph, const std::vector<int> &nodeIds);
+    };
+} // namespace TrackMapper::Web
+
+#endif // ROADTILEINDEX_H
@@ -0,0 +1,51 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "RouteCache.h"
+
+namespace TrackMapper::Web {
+    RouteCache::RouteCache(const size_t maxNodes) : mMaxNodes(maxNodes) {}
+
+    std::shared_ptr<const Path> RouteCache::Get(const int startNodeIndex, const int targetNodeIndex,
+                                                const std::string &graphVersion) {
+        const std::lock_guard lock(mMutex);
+        const auto it = mEntries.find(Key{startNodeIndex, targetNodeIndex, graphVersion});
+        mCounters.Record(it != mEntries.end());
+        if (it == mEntries.end())
+            return nullptr;
+
+        mUsage.splice(mUsage.begin(), mUsage, it->second.usage);
+        return it->second.path;
+    }
+
+    void RouteCache::Put(const int startNodeIndex, const int targetNodeIndex, const std::string &graphVersion,
+                         std::shared_ptr<const Path> path) {
+        Key key{startNodeIndex, targetNodeIndex, graphVersion};
+
+        const std::lock_guard lock(mMutex);
+        if (const auto it = mEntries.find(key); it != mEntries.end()) {
+            mNodes -= it->second.path->nodeIds.size();
+            mUsage.erase(it->second.usage);
+            mEntries.erase(it);
+        }
+
+        mNodes += path->nodeIds.size();
+        mUsage.push_front(key);
+        mEntries.emplace(std::move(key), Entry{std::move(path), mUsage.begin()});
+
+        // always keeps the newest path, even if it alone exceeds the limit
+        while (mNodes > mMaxNodes && mUsage.size() > 1) {
+            const auto it = mEntries.find(mUsage.back());
+            mNodes -= it->second.path->nodeIds.size();
+            mEntries.erase(it);
+            mUsage.pop_back();
+        }
+    }
+
+    size_t RouteCache::KeyHash::operator()(const Key &key) const {
+        const size_t nodesHash = std::hash<uint64_t>{}(static_cast<uint64_t>(key.startNodeIndex) << 32 |
+                                                       static_cast<uint32_t>(key.targetNodeIndex));
+        return nodesHash ^ std::hash<std::string>{}(key.graphVersion) * 31;
+    }
+} // namespace TrackMapper::Web
@@ -0,0 +1,63 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef ROUTECACHE_H
+#define ROUTECACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "../graph/DijkstraPathfinding.h"
+#include "Metrics.h"
+
+namespace TrackMapper::Web {
+    /// Keeps calculated paths in memory, evicting the least recently used ones
+    /// @note Paths are keyed by start, target and graph version, so paths of a replaced graph are never returned
+    /// @note All methods are thread safe
+    class RouteCache {
+    public:
+        /// @param maxNodes Total number of path nodes kept in memory, 4 bytes each
+        explicit RouteCache(size_t maxNodes);
+
+        /// @return cached path or nullptr if it is not cached
+        [[nodiscard]] std::shared_ptr<const Path> Get(int startNodeIndex, int targetNodeIndex,
+                                                      const std::string &graphVersion);
+
+        void Put(int startNodeIndex, int targetNodeIndex, const std::string &graphVersion,
+                 std::shared_ptr<const Path> path);
+
+        [[nodiscard]] const CacheCounters &GetCounters() const { return mCounters; }
+
+    private:
+        struct Key {
+            int startNodeIndex;
+            int targetNodeIndex;
+            std::string graphVersion;
+
+            bool operator==(const Key &other) const = default;
+        };
+        struct KeyHash {
+            size_t operator()(const Key &key) const;
+        };
+        struct Entry {
+            std::shared_ptr<const Path> path;
+            std::list<Key>::iterator usage;
+        };
+
+        const size_t mMaxNodes;
+
+        std::mutex mMutex;
+        std::unordered_map<Key, Entry, KeyHash> mEntries;
+        std::list<Key> mUsage; // keys ordered from most to least recently used
+        size_t mNodes = 0;
+
+        CacheCounters mCounters;
+    };
+} // namespace TrackMapper::Web
+
+#endif // ROUTECACHE_H
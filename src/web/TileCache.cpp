@@ -0,0 +1,177 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "TileCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+namespace TrackMapper::Web {
+    TileCache::TileCache(std::string directory, const size_t maxMemoryBytes, const size_t maxDiskBytes) :
+        mDirectory(std::move(directory)), mMaxMemoryBytes(maxMemoryBytes), mMaxDiskBytes(maxDiskBytes) {
+        if (mDirectory.empty())
+            return;
+
+        // tiles of previous runs count against the limit as well, the oldest files are the least recently used ones
+        std::vector<std::tuple<std::filesystem::file_time_type, std::string, size_t>> files;
+        std::vector<std::filesystem::path> tmpFiles;
+        std::error_code ec;
+        for (auto it = std::filesystem::recursive_directory_iterator(mDirectory, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_regular_file(ec))
+                continue;
+            if (it->path().extension().string().starts_with(".tmp")) {
+                tmpFiles.push_back(it->path()); // left over by a crash while writing
+                continue;
+            }
+            const auto key = it->path().lexically_relative(mDirectory).generic_string();
+            files.emplace_back(it->last_write_time(ec), key, it->file_size(ec));
+        }
+        for (const auto &tmpFile: tmpFiles) {
+            std::filesystem::remove(tmpFile, ec);
+        }
+
+        std::ranges::sort(files);
+        std::vector<std::string> evicted;
+        for (const auto &[_, key, size]: files) {
+            const auto evictedByFile = mInsertFile(key, size);
+            evicted.insert(evicted.end(), evictedByFile.begin(), evictedByFile.end());
+        }
+        mRemoveFiles(evicted);
+    }
+
+    std::shared_ptr<const std::string> TileCache::Get(const std::string &key) {
+        {
+            const std::lock_guard lock(mMutex);
+            if (const auto it = mEntries.find(key); it != mEntries.end()) {
+                mUsage.splice(mUsage.begin(), mUsage, it->second.usage);
+                mMemoryCounters.Record(true);
+                return it->second.data;
+            }
+        }
+        mMemoryCounters.Record(false);
+
+        if (mDirectory.empty())
+            return nullptr;
+
+        // reading the file happens outside of the lock, so slow disks don't block lookups of other tiles
+        std::ifstream file(std::filesystem::path(mDirectory) / key, std::ios::binary);
+        if (!file) {
+            mDiskCounters.Record(false);
+            return nullptr;
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        mDiskCounters.Record(true);
+
+        auto data = std::make_shared<const std::string>(std::move(content).str());
+        const std::lock_guard lock(mMutex);
+        mInsert(key, data);
+        if (const auto it = mDiskEntries.find(key); it != mDiskEntries.end()) {
+            mDiskUsage.splice(mDiskUsage.begin(), mDiskUsage, it->second.usage);
+        }
+        return data;
+    }
+
+    void TileCache::Put(const std::string &key, std::string data) {
+        const auto shared = std::make_shared<const std::string>(std::move(data));
+        {
+            const std::lock_guard lock(mMutex);
+            mInsert(key, shared);
+        }
+
+        if (mDirectory.empty())
+            return;
+
+        // writes to a temporary file first, so other threads never read a partially written tile
+        static std::atomic<uint64_t> fileCounter = 0;
+        const auto path = std::filesystem::path(mDirectory) / key;
+        auto tmpPath = path;
+        tmpPath += ".tmp" + std::to_string(fileCounter++);
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        {
+            std::ofstream file(tmpPath, std::ios::binary);
+            file.write(shared->data(), static_cast<std::streamsize>(shared->size()));
+            if (!file) {
+                file.close();
+                std::filesystem::remove(tmpPath, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmpPath, ec);
+            return;
+        }
+
+        std::vector<std::string> evicted;
+        {
+            const std::lock_guard lock(mMutex);
+            evicted = mInsertFile(key, shared->size());
+        }
+        mRemoveFiles(evicted);
+    }
+
+    void TileCache::mInsert(const std::string &key, std::shared_ptr<const std::string> data) {
+        if (const auto it = mEntries.find(key); it != mEntries.end()) {
+            mMemoryBytes -= it->second.data->size();
+            mUsage.erase(it->second.usage);
+            mEntries.erase(it);
+        }
+
+        mMemoryBytes += data->size();
+        mUsage.push_front(key);
+        mEntries[key] = Entry{std::move(data), mUsage.begin()};
+
+        // always keeps the newest tile, even if it alone exceeds the limit
+        while (mMemoryBytes > mMaxMemoryBytes && mUsage.size() > 1) {
+            const auto it = mEntries.find(mUsage.back());
+            mMemoryBytes -= it->second.data->size();
+            mEntries.erase(it);
+            mUsage.pop_back();
+        }
+    }
+
+    std::vector<std::string> TileCache::mInsertFile(const std::string &key, const size_t size) {
+        if (const auto it = mDiskEntries.find(key); it != mDiskEntries.end()) {
+            mDiskBytes -= it->second.size;
+            mDiskUsage.erase(it->second.usage);
+            mDiskEntries.erase(it);
+        }
+
+        mDiskBytes += size;
+        mDiskUsage.push_front(key);
+        mDiskEntries[key] = DiskEntry{size, mDiskUsage.begin()};
+
+        std::vector<std::string> evicted;
+        while (mDiskBytes > mMaxDiskBytes && mDiskUsage.size() > 1) {
+            const auto it = mDiskEntries.find(mDiskUsage.back());
+            mDiskBytes -= it->second.size;
+            mDiskEntries.erase(it);
+            evicted.push_back(std::move(mDiskUsage.back()));
+            mDiskUsage.pop_back();
+        }
+        return evicted;
+    }
+
+    void TileCache::mRemoveFiles(const std::vector<std::string> &keys) const {
+        const std::filesystem::path directory(mDirectory);
+        std::error_code ec;
+        for (const auto &key: keys) {
+            std::filesystem::remove(directory / key, ec);
+            // drops the directories left empty, e.g. the ones of rasters that changed since their tiles got rendered
+            for (auto parent = std::filesystem::path(key).parent_path(); !parent.empty();
+                 parent = parent.parent_path()) {
+                if (!std::filesystem::remove(directory / parent, ec))
+                    break; // still contains other tiles
+            }
+        }
+    }
+} // namespace TrackMapper::Web
@@ -0,0 +1,78 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Metrics.h"
+
+namespace TrackMapper::Web {
+    /// Keeps rendered tiles in memory and on disk in between runs, both evicting the least recently used ones
+    /// @note All methods are thread safe
+    class TileCache {
+    public:
+        /**
+         * @param directory Directory to store tiles in, gets created if it does not exist. Leave empty to only keep
+         * tiles in memory.
+         * @param maxMemoryBytes Total size of the tiles kept in memory
+         * @param maxDiskBytes Total size of the tiles kept on disk, tiles left from previous runs count as well
+         */
+        TileCache(std::string directory, size_t maxMemoryBytes, size_t maxDiskBytes);
+
+        /**
+         * @param key Identifies the tile, has to be a relative file path as it also names the file on disk
+         * @return data of the tile or nullptr if it is not cached
+         */
+        [[nodiscard]] std::shared_ptr<const std::string> Get(const std::string &key);
+
+        void Put(const std::string &key, std::string data);
+
+        [[nodiscard]] const CacheCounters &GetMemoryCounters() const { return mMemoryCounters; }
+        [[nodiscard]] const CacheCounters &GetDiskCounters() const { return mDiskCounters; }
+
+    private:
+        struct Entry {
+            std::shared_ptr<const std::string> data;
+            std::list<std::string>::iterator usage;
+        };
+
+        struct DiskEntry {
+            size_t size;
+            std::list<std::string>::iterator usage;
+        };
+
+        const std::string mDirectory;
+        const size_t mMaxMemoryBytes;
+        const size_t mMaxDiskBytes;
+
+        std::mutex mMutex;
+        std::unordered_map<std::string, Entry> mEntries;
+        std::list<std::string> mUsage; // keys ordered from most to least recently used
+        size_t mMemoryBytes = 0;
+        std::unordered_map<std::string, DiskEntry> mDiskEntries;
+        std::list<std::string> mDiskUsage; // keys of the files ordered from most to least recently used
+        size_t mDiskBytes = 0;
+
+        CacheCounters mMemoryCounters;
+        CacheCounters mDiskCounters;
+
+        /// Expects the mutex to be locked
+        void mInsert(const std::string &key, std::shared_ptr<const std::string> data);
+        /// Expects the mutex to be locked
+        /// @return keys of the files to delete to get back under the disk limit, already removed from the cache
+        std::vector<std::string> mInsertFile(const std::string &key, size_t size);
+        /// Expects the mutex to not be locked
+        void mRemoveFiles(const std::vector<std::string> &keys) const;
+    };
+} // namespace TrackMapper::Web
+
+#endif // TILECACHE_H
@@ -5,72 +5,144 @@
 #ifndef TRACKDATA_H
 #define TRACKDATA_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include "../mesh/raster_reader.h"
 
+/// Snapshot of the track creation progress, gets pushed to listeners on every change
+struct ProgressEvent {
+    int jobId = -1;
+    std::string progress; // human readable progress msg
+    int stage = 0; // current stage starting at 1, 0 if track creation has not started yet
+    int stageCount = 0;
+    double stageFraction = 0; // completed fraction of the current stage
+    double elapsedSeconds = 0; // time since the track data was received
+    std::string error;
+    bool finished = false;
+    int previewLevel = -1; // finest preview mesh rendered so far, -1 if there is none yet
+};
+
 struct TrackData {
+    using ProgressListener = std::function<void(const ProgressEvent &)>;
+
     using Path = std::vector<TrackMapper::Raster::OSMPoint>;
 
     std::string name;
     std::vector<std::string> rasterFiles;
-    std::vector<Path> paths;
+    std::vector<std::vector<int>> waypointNodes; // node ids of the waypoints of each path
+    std::string graphVersion; // version of the graph the node ids belong to
+    std::vector<Path> paths; // all nodes of each path, resolved from the waypoints by the track job
     std::string outputPath;
     TrackMapper::Raster::ProjectionWrapper projRef;
 
 private:
-    std::string progress;
-    std::string error;
-    bool isPopulated = false;
-    bool isFinished = false;
+    ProgressEvent event;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::atomic<bool> isCancelled = false;
+    ProgressListener listener;
+    std::shared_ptr<const std::string> preview; // binary gltf of the preview at event.previewLevel
 
     std::mutex mutex;
 
-public:
-    void SetPopulated() {
-        const std::lock_guard lock(mutex);
-        isPopulated = true;
+    /// Updates the event and notifies the listener outside of the lock, so slow listeners don't block readers
+    template<typename TUpdate>
+    void UpdateEvent(TUpdate update) {
+        ProgressEvent copy;
+        {
+            const std::lock_guard lock(mutex);
+            update(event);
+            event.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            if (!listener)
+                return;
+            copy = event;
+        }
+        listener(copy);
     }
-    void UnSetPopulated() {
+
+public:
+    /// Sets the function called on every progress change, must be set before the track gets enqueued
+    void SetProgressListener(ProgressListener progressListener) {
         const std::lock_guard lock(mutex);
-        isPopulated = false;
+        listener = std::move(progressListener);
     }
 
-    [[nodiscard]] bool IsPopulated() {
+    void SetJobId(const int jobId) {
         const std::lock_guard lock(mutex);
-        return isPopulated;
+        event.jobId = jobId;
     }
 
+    /// Requests the track creation to stop, gets checked between the creation steps
+    void Cancel() { isCancelled.store(true, std::memory_order_relaxed); }
+
+    [[nodiscard]] bool IsCancelled() const { return isCancelled.load(std::memory_order_relaxed); }
+
     void SetFinished() {
-        const std::lock_guard lock(mutex);
-        isFinished = true;
+        UpdateEvent([](ProgressEvent &e) {
+            e.finished = true;
+            e.stageFraction = 1;
+        });
     }
 
     [[nodiscard]] bool IsFinished() {
         const std::lock_guard lock(mutex);
-        return isFinished;
+        return event.finished;
     }
 
     void SetProgress(const std::string &progressText) {
-        const std::lock_guard lock(mutex);
-        progress = progressText;
+        UpdateEvent([&progressText](ProgressEvent &e) { e.progress = progressText; });
+    }
+
+    void SetProgress(const std::string &progressText, const int stage, const int stageCount,
+                     const double stageFraction) {
+        UpdateEvent([&](ProgressEvent &e) {
+            e.progress = progressText;
+            e.stage = stage;
+            e.stageCount = stageCount;
+            e.stageFraction = stageFraction;
+        });
     }
 
     [[nodiscard]] std::string GetProgress() {
         const std::lock_guard lock(mutex);
-        return progress; // copies string
+        return event.progress; // copies string
     }
 
     void SetError(const std::string &errorText) {
-        const std::lock_guard lock(mutex);
-        error = errorText;
+        UpdateEvent([&errorText](ProgressEvent &e) { e.error = errorText; });
     }
 
     [[nodiscard]] std::string GetError() {
         const std::lock_guard lock(mutex);
-        return error; // copies string
+        return event.error; // copies string
+    }
+
+    /// Replaces the preview mesh if it is finer than the current one, listeners get notified about the new level
+    void SetPreview(const int level, std::string glb) {
+        auto newPreview = std::make_shared<const std::string>(std::move(glb));
+        UpdateEvent([&](ProgressEvent &e) {
+            if (level > e.previewLevel) {
+                e.previewLevel = level;
+                preview = std::move(newPreview);
+            }
+        });
+    }
+
+    /// @return binary gltf of the finest preview so far, nullptr if there is none yet
+    [[nodiscard]] std::shared_ptr<const std::string> GetPreview(int &level) {
+        const std::lock_guard lock(mutex);
+        level = event.previewLevel;
+        return preview;
+    }
+
+    [[nodiscard]] ProgressEvent GetProgressEvent() {
+        const std::lock_guard lock(mutex);
+        return event; // copies strings
     }
 };
 
@@ -0,0 +1,162 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "TrackJobQueue.h"
+
+#include <algorithm>
+#include <format>
+#include <ranges>
+
+#include "errors.h"
+
+namespace TrackMapper::Web {
+    constexpr size_t MAX_KEPT_FINISHED_JOBS = 64;
+
+    TrackJobQueue::TrackJobQueue(JobFunction job, const int workerCount, const int maxPendingJobs) :
+        mJob(std::move(job)), mMaxPendingJobs(std::max(0, maxPendingJobs)) {
+        mWorkers.reserve(std::max(1, workerCount));
+        for (int i = 0; i < std::max(1, workerCount); ++i) {
+            mWorkers.emplace_back(&TrackJobQueue::mRunWorker, this);
+        }
+    }
+
+    TrackJobQueue::~TrackJobQueue() {
+        {
+            const std::lock_guard lock(mMutex);
+            mStopping = true;
+            for (const auto &data: mJobs | std::views::values) {
+                data->Cancel();
+            }
+        }
+        mJobAvailable.notify_all();
+
+        for (auto &worker: mWorkers) {
+            worker.join();
+        }
+    }
+
+    int TrackJobQueue::Enqueue(const std::shared_ptr<TrackData> &data) {
+        // calls the progress listener, so it has to happen outside the lock, and before a worker can pick up the job
+        data->SetProgress("Waiting for a free worker");
+
+        int jobId;
+        {
+            const std::lock_guard lock(mMutex);
+            if (mStopping || mPendingJobs.size() >= mMaxPendingJobs)
+                return -1;
+
+            jobId = mNextJobId++;
+            data->SetJobId(jobId);
+            mJobs.emplace(jobId, data);
+            mPendingJobs.push_back(jobId);
+        }
+        mJobAvailable.notify_one();
+
+        return jobId;
+    }
+
+    std::shared_ptr<TrackData> TrackJobQueue::GetJob(const int jobId) const {
+        const std::lock_guard lock(mMutex);
+        const auto it = mJobs.find(jobId);
+        return it == mJobs.end() ? nullptr : it->second;
+    }
+
+    std::vector<int> TrackJobQueue::GetJobIds() const {
+        const std::lock_guard lock(mMutex);
+        std::vector<int> jobIds;
+        jobIds.reserve(mJobs.size());
+        for (const auto jobId: mJobs | std::views::keys) {
+            jobIds.push_back(jobId);
+        }
+        return jobIds;
+    }
+
+    bool TrackJobQueue::Cancel(const int jobId) {
+        std::shared_ptr<TrackData> data;
+        bool wasPending;
+        {
+            const std::lock_guard lock(mMutex);
+            const auto it = mJobs.find(jobId);
+            if (it == mJobs.end() || std::ranges::find(mFinishedJobs, jobId) != mFinishedJobs.end())
+                return false;
+
+            data = it->second;
+            data->Cancel();
+
+            // pending jobs never reach a worker, so they get finished right here
+            const auto pendingIt = std::ranges::find(mPendingJobs, jobId);
+            wasPending = pendingIt != mPendingJobs.end();
+            if (wasPending) {
+                mPendingJobs.erase(pendingIt);
+                mFinishedJobs.push_back(jobId);
+                mEvictFinishedJobs();
+            }
+        }
+
+        if (wasPending) {
+            data->SetError(ERROR_CANCELLED);
+            mJobFinished.notify_all();
+        }
+        return true;
+    }
+
+    void TrackJobQueue::WaitUntilIdle() {
+        std::unique_lock lock(mMutex);
+        mJobFinished.wait(lock, [this] { return mPendingJobs.empty() && mRunningJobs == 0; });
+    }
+
+    int TrackJobQueue::GetRunningJobCount() const {
+        const std::lock_guard lock(mMutex);
+        return mRunningJobs;
+    }
+
+    int TrackJobQueue::GetPendingJobCount() const {
+        const std::lock_guard lock(mMutex);
+        return static_cast<int>(mPendingJobs.size());
+    }
+
+    void TrackJobQueue::mRunWorker() {
+        while (true) {
+            int jobId;
+            std::shared_ptr<TrackData> data;
+            {
+                std::unique_lock lock(mMutex);
+                mJobAvailable.wait(lock, [this] { return mStopping || !mPendingJobs.empty(); });
+                if (mStopping)
+                    return;
+
+                jobId = mPendingJobs.front();
+                mPendingJobs.pop_front();
+                data = mJobs.at(jobId);
+                ++mRunningJobs;
+            }
+
+            // a failing job must not take down its worker
+            try {
+                mJob(*data);
+            } catch (const std::exception &e) {
+                const std::string msg = e.what();
+                data->SetError(std::vformat(ERROR_TRACK_FAILED, std::make_format_args(msg)));
+            } catch (...) {
+                const std::string msg = "unknown error";
+                data->SetError(std::vformat(ERROR_TRACK_FAILED, std::make_format_args(msg)));
+            }
+
+            {
+                const std::lock_guard lock(mMutex);
+                --mRunningJobs;
+                mFinishedJobs.push_back(jobId);
+                mEvictFinishedJobs();
+            }
+            mJobFinished.notify_all();
+        }
+    }
+
+    void TrackJobQueue::mEvictFinishedJobs() {
+        while (mFinishedJobs.size() > MAX_KEPT_FINISHED_JOBS) {
+            mJobs.erase(mFinishedJobs.front());
+            mFinishedJobs.pop_front();
+        }
+    }
+} // namespace TrackMapper::Web
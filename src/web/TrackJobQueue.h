@@ -0,0 +1,80 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef TRACKJOBQUEUE_H
+#define TRACKJOBQUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TrackData.h"
+
+namespace TrackMapper::Web {
+    /// Runs track creation jobs on a fixed number of worker threads
+    /// @note Jobs wait in a bounded queue until a worker is free
+    class TrackJobQueue {
+    public:
+        /// Creates the track described by the data, reports failures by setting an error on the data
+        using JobFunction = std::function<void(TrackData &)>;
+
+        /**
+         * @param job Function run for every enqueued job, gets called from multiple worker threads at once
+         * @param workerCount Maximum number of jobs running at the same time
+         * @param maxPendingJobs Maximum number of jobs waiting for a worker, further jobs get rejected
+         */
+        TrackJobQueue(JobFunction job, int workerCount, int maxPendingJobs);
+
+        /// Cancels all jobs and waits for the running ones to stop
+        ~TrackJobQueue();
+
+        TrackJobQueue(const TrackJobQueue &) = delete;
+        TrackJobQueue &operator=(const TrackJobQueue &) = delete;
+
+        /// @return id of the job or -1 if too many jobs are pending
+        [[nodiscard]] int Enqueue(const std::shared_ptr<TrackData> &data);
+
+        /// @return data of the job or nullptr if no job with this id is known (anymore)
+        [[nodiscard]] std::shared_ptr<TrackData> GetJob(int jobId) const;
+
+        /// @return ids of all known jobs in order of submission
+        [[nodiscard]] std::vector<int> GetJobIds() const;
+
+        /// Pending jobs get removed, running jobs stop at the next cancellation check of the job function
+        /// @return false if no unfinished job with this id is known
+        bool Cancel(int jobId);
+
+        /// Blocks until no job is pending or running anymore
+        void WaitUntilIdle();
+
+        [[nodiscard]] int GetRunningJobCount() const;
+        [[nodiscard]] int GetPendingJobCount() const;
+
+    private:
+        JobFunction mJob;
+        const size_t mMaxPendingJobs;
+
+        mutable std::mutex mMutex;
+        std::condition_variable mJobAvailable;
+        std::condition_variable mJobFinished;
+        std::deque<int> mPendingJobs;
+        std::map<int, std::shared_ptr<TrackData>> mJobs; // finished jobs are kept for clients to query their state
+        std::deque<int> mFinishedJobs; // in order of completion, oldest get evicted first
+        int mNextJobId = 0;
+        int mRunningJobs = 0;
+        bool mStopping = false;
+
+        std::vector<std::thread> mWorkers;
+
+        void mRunWorker();
+        void mEvictFinishedJobs();
+    };
+} // namespace TrackMapper::Web
+
+#endif // TRACKJOBQUEUE_H
@@ -0,0 +1,219 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include "TrackPreview.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../mesh/gdal_wrapper.h"
+#include "../mesh/raster_reader.h"
+#include "GlbWriter.h"
+
+namespace TrackMapper::Web {
+    constexpr double PREVIEW_MIN_MARGIN = 200; // meters of terrain around the paths
+    constexpr double PREVIEW_MARGIN_FRACTION = 0.1; // of the longer side of the bounding box of the paths
+    constexpr double PREVIEW_ROAD_WIDTH = 6; // same as the created track
+    constexpr double PREVIEW_ROAD_LIFT = 0.3; // meters above the terrain, so the road doesn't flicker into it
+
+    /// Heights at the cell centers of a regular grid in the projection of the track
+    struct PreviewGrid {
+        std::vector<float> heights; // row major, first row is the northern one, NaN where no raster has data
+        int sizeX = 0, sizeY = 0;
+        double minX = 0, maxY = 0, cellSize = 1;
+        float baseHeight = 0; // lowest height of the grid, becomes 0 in the preview
+
+        [[nodiscard]] float At(const int x, const int y) const { return heights[static_cast<size_t>(y) * sizeX + x]; }
+    };
+
+    static float get_grid_height(const PreviewGrid &grid, double x, double y);
+    static GlbMesh build_terrain_mesh(const PreviewGrid &grid, double centerX, double centerY);
+    static GlbMesh build_road_mesh(const PreviewGrid &grid, const std::vector<std::vector<Raster::OSMPoint>> &paths,
+                                   double centerX, double centerY);
+
+    std::string render_track_preview(const TrackData &data, const int gridSize) {
+        if (data.paths.empty() || data.rasterFiles.empty() || gridSize < 1)
+            return {};
+
+        // same projection the track creation will use, the rasters are expected to share it
+        const bool customProjRef = !data.projRef.Get().empty();
+        Raster::ProjectionWrapper projRef = data.projRef;
+        if (!customProjRef) {
+            const Raster::GDALDatasetWrapper dataset(data.rasterFiles[0]);
+            projRef = dataset.GetProjectionRef();
+        }
+        if (!projRef.IsValid())
+            return {};
+
+        // paths in the projection of the track, x is east and y is north
+        auto paths = data.paths;
+        double minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+        for (auto &path: paths) {
+            if (!Raster::reprojectOSMPoints(path, projRef))
+                return {};
+            for (const auto [x, y]: path) {
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+        if (!std::isfinite(minX) || !std::isfinite(minY))
+            return {};
+
+        const double extend = std::max(maxX - minX, maxY - minY);
+        const double margin = std::max(PREVIEW_MIN_MARGIN, PREVIEW_MARGIN_FRACTION * extend);
+        minX -= margin;
+        maxX += margin;
+        minY -= margin;
+        maxY += margin;
+
+        PreviewGrid grid;
+        grid.cellSize = std::max(maxX - minX, maxY - minY) / gridSize;
+        grid.sizeX = std::max(2, static_cast<int>(std::ceil((maxX - minX) / grid.cellSize)));
+        grid.sizeY = std::max(2, static_cast<int>(std::ceil((maxY - minY) / grid.cellSize)));
+        grid.minX = minX;
+        grid.maxY = maxY;
+        grid.heights.assign(static_cast<size_t>(grid.sizeX) * grid.sizeY, NAN);
+
+        // overlapping rasters don't overwrite each other, the first one with data for a cell wins
+        const Raster::GeoTransform transform{minX, grid.cellSize, 0, maxY, 0, -grid.cellSize};
+        for (const auto &rasterFile: data.rasterFiles) {
+            const Raster::GDALDatasetWrapper dataset(rasterFile);
+            if (!dataset.IsValid())
+                continue;
+
+            const auto &srcProjRef = customProjRef ? projRef : dataset.GetProjectionRef();
+            const auto heights = dataset.ReadWarped(srcProjRef, projRef, transform, grid.sizeX, grid.sizeY);
+            for (size_t i = 0; i < heights.size(); ++i) {
+                if (std::isnan(grid.heights[i])) {
+                    grid.heights[i] = heights[i];
+                }
+            }
+        }
+
+        const auto minHeight = std::ranges::min(grid.heights, [](const float a, const float b) {
+            return !std::isnan(a) && (std::isnan(b) || a < b); // NaN is bigger than any valid height
+        });
+        grid.baseHeight = std::isnan(minHeight) ? 0 : minHeight;
+
+        const double centerX = (minX + maxX) / 2, centerY = (minY + maxY) / 2;
+        return encode_glb({build_terrain_mesh(grid, centerX, centerY), build_road_mesh(grid, paths, centerX, centerY)});
+    }
+
+    /**
+     * Interpolates on the same triangles the terrain mesh consists of, so the roads follow the terrain exactly
+     * @return height relative to the base height of the grid, 0 outside the grid or next to cells without data
+     */
+    static float get_grid_height(const PreviewGrid &grid, const double x, const double y) {
+        // cell centers are the vertices of the terrain mesh
+        const double gx = (x - grid.minX) / grid.cellSize - 0.5;
+        const double gy = (grid.maxY - y) / grid.cellSize - 0.5;
+        const int i = std::clamp(static_cast<int>(std::floor(gx)), 0, grid.sizeX - 2);
+        const int j = std::clamp(static_cast<int>(std::floor(gy)), 0, grid.sizeY - 2);
+        const double u = std::clamp(gx - i, 0.0, 1.0), v = std::clamp(gy - j, 0.0, 1.0);
+
+        // quads are split along the diagonal from the top left to the bottom right corner
+        const double a = grid.At(i, j), b = grid.At(i + 1, j), c = grid.At(i, j + 1), d = grid.At(i + 1, j + 1);
+        const double height = u >= v ? a + u * (b - a) + v * (d - b) : a + v * (c - a) + u * (d - c);
+        return std::isnan(height) ? 0 : static_cast<float>(height - grid.baseHeight);
+    }
+
+    static GlbMesh build_terrain_mesh(const PreviewGrid &grid, const double centerX, const double centerY) {
+        GlbMesh mesh;
+        mesh.name = "terrain";
+        mesh.color = {0.32f, 0.42f, 0.24f, 1};
+        mesh.positions.reserve(grid.heights.size() * 3);
+        mesh.indices.reserve(grid.heights.size() * 6);
+
+        // x points east and z south, which keeps the mesh right-handed with y pointing up
+        for (int y = 0; y < grid.sizeY; ++y) {
+            for (int x = 0; x < grid.sizeX; ++x) {
+                const float height = grid.At(x, y);
+                mesh.positions.push_back(static_cast<float>(grid.minX + (x + 0.5) * grid.cellSize - centerX));
+                mesh.positions.push_back(std::isnan(height) ? 0 : height - grid.baseHeight);
+                mesh.positions.push_back(static_cast<float>(centerY - (grid.maxY - (y + 0.5) * grid.cellSize)));
+            }
+        }
+
+        const auto isValid = [&grid](const int x, const int y) { return !std::isnan(grid.At(x, y)); };
+        for (int y = 0; y + 1 < grid.sizeY; ++y) {
+            for (int x = 0; x + 1 < grid.sizeX; ++x) {
+                const uint32_t a = y * grid.sizeX + x, b = a + 1, c = a + grid.sizeX, d = c + 1;
+                // triangles touching cells without data get left out, so the terrain ends where the rasters end
+                if (isValid(x, y) && isValid(x + 1, y + 1)) {
+                    if (isValid(x, y + 1)) {
+                        mesh.indices.insert(mesh.indices.end(), {a, c, d});
+                    }
+                    if (isValid(x + 1, y)) {
+                        mesh.indices.insert(mesh.indices.end(), {a, d, b});
+                    }
+                }
+            }
+        }
+
+        compute_normals(mesh);
+        return mesh;
+    }
+
+    static GlbMesh build_road_mesh(const PreviewGrid &grid, const std::vector<std::vector<Raster::OSMPoint>> &paths,
+                                   const double centerX, const double centerY) {
+        GlbMesh mesh;
+        mesh.name = "roads";
+        mesh.color = {0.12f, 0.12f, 0.13f, 1};
+
+        // the road gets drawn wider than it is on coarse grids, otherwise it would be hidden by the terrain
+        const double halfWidth = std::max(PREVIEW_ROAD_WIDTH, grid.cellSize / 4) / 2;
+        const double lift = PREVIEW_ROAD_LIFT + grid.cellSize / 200;
+        const double spacing = grid.cellSize / 2; // follows the terrain between nodes that are far apart
+
+        for (const auto &path: paths) {
+            std::vector<Raster::OSMPoint> samples;
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                const auto [x0, y0] = path[i];
+                const auto [x1, y1] = path[i + 1];
+                const int steps = std::max(1, static_cast<int>(std::ceil(std::hypot(x1 - x0, y1 - y0) / spacing)));
+                for (int s = 0; s < steps; ++s) {
+                    const double t = static_cast<double>(s) / steps;
+                    samples.push_back({x0 + (x1 - x0) * t, y0 + (y1 - y0) * t});
+                }
+            }
+            if (!path.empty()) {
+                samples.push_back(path.back());
+            }
+            if (samples.size() < 2)
+                continue;
+
+            const auto firstVertex = static_cast<uint32_t>(mesh.positions.size() / 3);
+            for (size_t i = 0; i < samples.size(); ++i) {
+                // direction along the road, averaged at the inner points so the strip has no gaps in curves
+                const auto &prev = samples[i == 0 ? 0 : i - 1];
+                const auto &next = samples[std::min(i + 1, samples.size() - 1)];
+                double dirX = next.lat - prev.lat, dirY = next.lng - prev.lng;
+                const double length = std::hypot(dirX, dirY);
+                if (length > 0) {
+                    dirX /= length;
+                    dirY /= length;
+                }
+
+                const auto [x, y] = samples[i];
+                for (const double side: {-halfWidth, halfWidth}) {
+                    // perpendicular to the direction, pointing right for positive sides
+                    const double px = x + dirY * side, py = y - dirX * side;
+                    mesh.positions.push_back(static_cast<float>(px - centerX));
+                    mesh.positions.push_back(static_cast<float>(get_grid_height(grid, px, py) + lift));
+                    mesh.positions.push_back(static_cast<float>(centerY - py));
+                }
+            }
+            for (uint32_t i = 0; i + 1 < samples.size(); ++i) {
+                const uint32_t left = firstVertex + i * 2, right = left + 1, nextLeft = left + 2, nextRight = left + 3;
+                mesh.indices.insert(mesh.indices.end(), {left, right, nextLeft, right, nextRight, nextLeft});
+            }
+        }
+
+        compute_normals(mesh);
+        return mesh;
+    }
+} // namespace TrackMapper::Web
@@ -0,0 +1,27 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef TRACK_PREVIEW_H
+#define TRACK_PREVIEW_H
+
+#include <array>
+#include <string>
+
+#include "TrackData.h"
+
+namespace TrackMapper::Web {
+    // terrain cells along the longer side of the previewed area for each preview level, coarse levels are ready
+    // within a second and get replaced by finer ones while the track gets created
+    constexpr std::array PREVIEW_GRID_SIZES{64, 192, 384};
+
+    /**
+     * Renders a heavily simplified version of the track, a heightfield around the paths with the roads on top
+     * @param gridSize number of terrain cells along the longer side of the area around the paths
+     * @return binary gltf file, empty if the track has no paths or its projection is unknown
+     * @note Reads the rasters warped into a coarse grid, which is fast because only overviews or few pixels get read
+     */
+    std::string render_track_preview(const TrackData &data, int gridSize);
+} // namespace TrackMapper::Web
+
+#endif // TRACK_PREVIEW_H
@@ -0,0 +1,103 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#ifndef VECTORTILE_H
+#define VECTORTILE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrackMapper::Web {
+    /// Number of coordinate units per side of a vector tile, 16 units per pixel of a 256 pixel tile
+    constexpr int MVT_EXTENT = 4096;
+
+    /// Position inside a vector tile, (0, 0) is the top left corner and (MVT_EXTENT, MVT_EXTENT) the bottom right one
+    struct TilePoint {
+        int32_t x, y;
+
+        bool operator==(const TilePoint &other) const = default;
+    };
+
+    /// Appends an unsigned value as protobuf varint, 7 bits per byte
+    inline void append_varint(std::string &out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    /// Appends a protobuf field holding bytes, like strings, packed values or embedded messages
+    inline void append_bytes_field(std::string &out, const int field, const std::string_view bytes) {
+        constexpr int lengthDelimited = 2;
+        append_varint(out, field << 3 | lengthDelimited);
+        append_varint(out, bytes.size());
+        out.append(bytes);
+    }
+
+    inline void append_varint_field(std::string &out, const int field, const uint64_t value) {
+        constexpr int varint = 0;
+        append_varint(out, field << 3 | varint);
+        append_varint(out, value);
+    }
+
+    /**
+     * Encodes the lines as a Mapbox Vector Tile with a single layer
+     * @param layerName Name used for styling the layer on the client
+     * @param lines Lines with at least 2 points each, the index of a line is used as the id of its feature
+     * @see https://github.com/mapbox/vector-tile-spec/tree/master/2.1
+     */
+    inline std::string encode_line_tile(const std::string_view layerName,
+                                        const std::vector<std::vector<TilePoint>> &lines) {
+        // field numbers of the vector tile protobuf schema
+        constexpr int tileLayersField = 3;
+        constexpr int layerVersionField = 15, layerNameField = 1, layerFeaturesField = 2, layerExtentField = 5;
+        constexpr int featureIdField = 1, featureTypeField = 3, featureGeometryField = 4;
+        constexpr int lineStringType = 2;
+        constexpr int moveTo = 1, lineTo = 2;
+
+        std::string layer;
+        append_varint_field(layer, layerVersionField, 2);
+        append_bytes_field(layer, layerNameField, layerName);
+        append_varint_field(layer, layerExtentField, MVT_EXTENT);
+
+        std::string geometry;
+        std::string feature;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            // commands are followed by zigzag encoded deltas to the previous point
+            geometry.clear();
+            int32_t prevX = 0, prevY = 0;
+            const auto appendPoint = [&geometry, &prevX, &prevY](const TilePoint point) {
+                const auto dx = static_cast<int32_t>(point.x - prevX);
+                const auto dy = static_cast<int32_t>(point.y - prevY);
+                append_varint(geometry, static_cast<uint32_t>(dx << 1) ^ static_cast<uint32_t>(dx >> 31));
+                append_varint(geometry, static_cast<uint32_t>(dy << 1) ^ static_cast<uint32_t>(dy >> 31));
+                prevX = point.x;
+                prevY = point.y;
+            };
+
+            const auto &line = lines[i];
+            append_varint(geometry, 1 << 3 | moveTo);
+            appendPoint(line[0]);
+            append_varint(geometry, (line.size() - 1) << 3 | lineTo);
+            for (size_t p = 1; p < line.size(); ++p) {
+                appendPoint(line[p]);
+            }
+
+            feature.clear();
+            append_varint_field(feature, featureIdField, i);
+            append_varint_field(feature, featureTypeField, lineStringType);
+            append_bytes_field(feature, featureGeometryField, geometry);
+            append_bytes_field(layer, layerFeaturesField, feature);
+        }
+
+        std::string tile;
+        append_bytes_field(tile, tileLayersField, layer);
+        return tile;
+    }
+} // namespace TrackMapper::Web
+
+#endif // VECTORTILE_H
@@ -0,0 +1,142 @@
+//
+// Created by Jost on 19/10/2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "crow.h"
+
+#include "../graph/IGraph.h"
+#include "JsonWriter.h"
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct LatencySummary {
+    double meanUs;
+    double medianUs;
+    double p95Us;
+};
+
+LatencySummary Summarize(std::vector<double> &samplesUs);
+
+void PrintSummary(const std::string &name, const LatencySummary &summary);
+
+std::string WritePathWithWValue(const std::vector<int> &nodeIds, const std::vector<Location> &locations);
+std::string WritePathWithJsonWriter(const std::vector<int> &nodeIds, const std::vector<Location> &locations);
+
+/**
+ * Measures serializing the nodes of long paths, the way '/api/get_path' responds, with crow::json::wvalue and with
+ * the JsonWriter
+ * Usage: TrackMapperWebBenchmark [repetitions]
+ * @note Uses random walks instead of a graph, the time depends only on the number of nodes
+ */
+int main(const int argc, char *argv[]) {
+    const int repetitions = argc > 1 ? std::stoi(argv[1]) : 50;
+
+    // fixed seed so all runs serialize the same paths
+    std::mt19937 rng(42);
+    std::uniform_real_distribution stepDistribution(-0.0005, 0.0005);
+
+    for (const int nodeCount: {10'000, 100'000}) {
+        std::vector<int> nodeIds(nodeCount);
+        std::vector<Location> locations(nodeCount);
+        Location location{49, 10};
+        for (int i = 0; i < nodeCount; ++i) {
+            nodeIds[i] = i;
+            location.latitude += stepDistribution(rng);
+            location.longitude += stepDistribution(rng);
+            locations[i] = location;
+        }
+
+        const auto measure = [&](const auto &write) {
+            std::vector<double> samples;
+            samples.reserve(repetitions);
+            size_t size = 0;
+            for (int i = 0; i < repetitions; ++i) {
+                const auto startTime = Clock::now();
+                size = write(nodeIds, locations).size();
+                const auto endTime = Clock::now();
+
+                samples.push_back(std::chrono::duration<double, std::micro>(endTime - startTime).count());
+            }
+            std::cout << " > " << size / 1024 << "KiB of json" << std::endl;
+            return Summarize(samples);
+        };
+
+        std::cout << "Path with " << nodeCount << " nodes:" << std::endl;
+        PrintSummary("wvalue", measure(WritePathWithWValue));
+        PrintSummary("JsonWriter", measure(WritePathWithJsonWriter));
+
+        // both have to describe the same path, only the formatting of the numbers may differ
+        const auto wvalueJson = crow::json::load(WritePathWithWValue(nodeIds, locations));
+        const auto writerJson = crow::json::load(WritePathWithJsonWriter(nodeIds, locations));
+        if (!wvalueJson || !writerJson || wvalueJson["nodes"].size() != writerJson["nodes"].size()) {
+            std::cout << "Serialized paths differ!" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+std::string WritePathWithWValue(const std::vector<int> &nodeIds, const std::vector<Location> &locations) {
+    std::vector<crow::json::wvalue> path;
+    path.reserve(nodeIds.size());
+    for (const auto nodeId: nodeIds) {
+        auto [latitude, longitude] = locations[nodeId];
+        crow::json::wvalue node;
+        node["nodeId"] = nodeId;
+        node["lat"] = latitude;
+        node["lon"] = longitude;
+
+        path.push_back(node);
+    }
+
+    crow::json::wvalue x;
+    x["distance"] = 0;
+    x["nodes"] = std::move(path);
+    return x.dump();
+}
+
+std::string WritePathWithJsonWriter(const std::vector<int> &nodeIds, const std::vector<Location> &locations) {
+    TrackMapper::Web::JsonWriter json(nodeIds.size() * 64 + 256);
+    json.BeginObject();
+    json.Key("distance").Int(0);
+    json.Key("nodes").BeginArray();
+    for (const auto nodeId: nodeIds) {
+        auto [latitude, longitude] = locations[nodeId];
+        json.BeginObject();
+        json.Key("nodeId").Int(nodeId);
+        json.Key("lat").Double(latitude);
+        json.Key("lon").Double(longitude);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    return json.Take();
+}
+
+LatencySummary Summarize(std::vector<double> &samplesUs) {
+    if (samplesUs.empty())
+        return {0, 0, 0};
+
+    std::ranges::sort(samplesUs);
+
+    double sum = 0;
+    for (const double sample: samplesUs) {
+        sum += sample;
+    }
+
+    return {sum / static_cast<double>(samplesUs.size()), samplesUs[samplesUs.size() / 2],
+            samplesUs[samplesUs.size() * 95 / 100]};
+}
+
+void PrintSummary(const std::string &name, const LatencySummary &summary) {
+    std::cout << name << ": mean " << summary.meanUs << "us, median " << summary.medianUs << "us, p95 "
+              << summary.p95Us << "us" << std::endl;
+}
@@ -16,5 +16,17 @@ inline const std::string ERROR_NO_PATH = "[ERROR_T1] No paths were provided, at
 inline const std::string ERROR_NO_OUT_LOC = "[ERROR_T2] No output location was provided!";
 inline const std::string ERROR_OUT_NOT_DIR = "[ERROR_T3] Provided output location is not a directory, please provide a valid path to a directory!";
 inline const std::string ERROR_INVALID_OUT_LOC = "[ERROR_T4] Provided output location is invalid!\n\n{}";
+inline const std::string ERROR_CANCELLED = "[ERROR_T5] Track creation was cancelled!";
+inline const std::string ERROR_TRACK_FAILED = "[ERROR_T6] Track creation failed unexpectedly:\n\n{}";
+inline const std::string ERROR_BODY_TOO_LARGE = "[ERROR_W0] Request body exceeds the limit of {} bytes!";
+inline const std::string ERROR_INVALID_JSON = "[ERROR_W1] Request body is not valid json!";
+inline const std::string ERROR_QUEUE_FULL = "[ERROR_W2] Too many tracks are waiting to be created, please try again later!";
+inline const std::string ERROR_UNKNOWN_JOB = "[ERROR_W3] No unfinished track job with id {} exists!";
+inline const std::string ERROR_INVALID_TILE = "[ERROR_W4] Tile {}/{}/{} does not exist!";
+inline const std::string ERROR_UNKNOWN_RASTER = "[ERROR_W5] No raster with id {} was added!";
+inline const std::string ERROR_INVALID_NODE = "[ERROR_W6] Path contains the node {}, which does not exist!";
+inline const std::string ERROR_GRAPH_CHANGED = "[ERROR_W7] The graph was reloaded after the track was submitted, please redraw the paths!";
+inline const std::string ERROR_RELOAD_RUNNING = "[ERROR_W8] Another graph is still being loaded, please try again later!";
+inline const std::string ERROR_NOT_LOCAL = "[ERROR_W9] Admin endpoints can only be used from the local machine!";
 
 #endif // ERROR_CODES_H
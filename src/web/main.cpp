@@ -4,20 +4,35 @@
 
 #include "BasicWebApp.h"
 
+#include <algorithm>
 #include <csignal>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string_view>
+#include <vector>
 
 #include "../mesh/gdal_wrapper.h"
 #include "../scene/TrackCreator.h"
 #include "TrackData.h"
+#include "TrackJobQueue.h"
+#include "TrackPreview.h"
 #include "errors.h"
 
 void TrackWebApp();
+int TrackBatch(const std::vector<std::string> &args);
+void RunTrackJob(TrackData &data);
+bool CheckCancelled(TrackData &data);
 bool CreateTrack(TrackData &data);
+void RenderPreview(TrackData &data, int level);
 void OpenWebpage(const std::string &url);
 
+constexpr int MAX_CONCURRENT_TRACK_JOBS = 2; // track creation needs a lot of memory for big rasters
+constexpr int MAX_PENDING_TRACK_JOBS = 16;
+// bigger rasters get read decimated, keeps typical 1m tiles of a few km at full resolution for the road heights
+constexpr int64_t MAX_TERRAIN_POINTS = 16'000'000;
+
 std::unique_ptr<TrackMapper::Web::BasicWebApp> pApp;
 
 void close_gracefully() {
@@ -29,7 +44,11 @@ void close_gracefully() {
 void close_gracefully(const int signal) { close_gracefully(); };
 
 
-int main() {
+int main(const int argc, char *argv[]) {
+    // creates tracks from job files without the web interface, e.g. for regenerating many tracks on a build machine
+    if (argc > 1 && std::string_view(argv[1]) == "--batch")
+        return TrackBatch(std::vector<std::string>(argv + 2, argv + argc));
+
     // tries to gracefully clean up if possible
     std::signal(SIGINT, close_gracefully);
     std::signal(SIGTERM, close_gracefully);
@@ -41,61 +60,158 @@ int main() {
 
 void TrackWebApp() {
     try {
-        std::cout << "Enter Path to fmi file:" << std::endl;
+        std::cout << "Enter Path to fmi or osm.pbf file:" << std::endl;
 
         std::string filePath;
         std::cin >> filePath;
 
         pApp = std::make_unique<TrackMapper::Web::BasicWebApp>(filePath);
-        TrackData data;
 
-        pApp->Start(data);
+        // runs the track creation of all users, graph and caches of the web app are shared between the jobs
+        TrackMapper::Web::TrackJobQueue jobQueue(RunTrackJob, MAX_CONCURRENT_TRACK_JOBS, MAX_PENDING_TRACK_JOBS);
+
+        pApp->Start(jobQueue);
         OpenWebpage("http://localhost:18080/static/index.html");
 
-        bool success = false;
-        while (!success) {
-            std::cout << "Waiting for input from web app.." << std::endl;
-            while (!data.IsPopulated()) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-            }
+        // waits for user input before closing console app
+        std::cout << "Press ENTER to close process" << std::endl;
+        std::cin.ignore();
+        std::string await;
+        std::getline(std::cin, await);
+        std::cout << await; // so variable does not get removed by optimizer
 
-            std::cout << "Received data.. Creating Track.." << std::endl;
-            auto startTime = std::chrono::high_resolution_clock::now();
+        // stops the server first so no new jobs can be enqueued while the queue shuts down
+        close_gracefully();
+    } catch (const std::exception &e) {
+        std::cout << e.what() << std::endl;
+    } catch (...) {
+        std::cout << "An unknown error happend :(" << std::endl;
+    }
+}
 
-            success = CreateTrack(data);
+/**
+ * Creates a track for every job file, the graph gets loaded once and is shared by all jobs
+ * Usage: TrackMapperServerWebApp --batch <path to fmi or osm.pbf file> [--jobs <count>] <job file>...
+ * @note Job files contain the json the web interface submits, waypoints can also be given as objects with 'lat' and
+ * 'lon'. Relative paths in them are relative to the job file and missing output folders get created
+ * @return 0 if all tracks got created, 1 otherwise
+ */
+int TrackBatch(const std::vector<std::string> &args) {
+    std::string graphPath;
+    int workerCount = MAX_CONCURRENT_TRACK_JOBS;
+    std::vector<std::string> jobFiles;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--jobs" && i + 1 < args.size()) {
+            workerCount = std::max(1, std::atoi(args[++i].c_str()));
+        } else if (graphPath.empty()) {
+            graphPath = args[i];
+        } else {
+            jobFiles.push_back(args[i]);
+        }
+    }
+    if (graphPath.empty() || jobFiles.empty()) {
+        std::cout << "Usage: TrackMapperServerWebApp --batch <path to fmi or osm.pbf file> [--jobs <count>] "
+                     "<job file>..."
+                  << std::endl;
+        return 1;
+    }
 
-            auto endTime = std::chrono::high_resolution_clock::now();
-            auto creationTime = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    try {
+        pApp = std::make_unique<TrackMapper::Web::BasicWebApp>(graphPath);
+        TrackMapper::Web::TrackJobQueue jobQueue(RunTrackJob, workerCount, static_cast<int>(jobFiles.size()));
+
+        std::vector<std::shared_ptr<TrackData>> jobs(jobFiles.size());
+        for (int i = 0; i < jobFiles.size(); ++i) {
+            const std::filesystem::path jobPath(jobFiles[i]);
+            std::ifstream jobFile(jobPath);
+            if (!jobFile) {
+                std::cout << jobFiles[i] << ": " << std::vformat(ERROR_INVALID_FILE, std::make_format_args(jobFiles[i]))
+                          << std::endl;
+                continue;
+            }
+            std::stringstream json;
+            json << jobFile.rdbuf();
 
-            if (!success) {
-                // resets track data to be set again by web app
-                data.rasterFiles.clear();
-                data.paths.clear();
-                data.projRef = TrackMapper::Raster::ProjectionWrapper();
-                // TODO: possible deadlock
-                // -> if website sends new create_track request between SetError in CreateTrack and this line
-                data.UnSetPopulated();
+            const auto data = std::make_shared<TrackData>();
+            if (const auto error = pApp->ReadTrackJob(json.str(), *data); !error.empty()) {
+                std::cout << jobFiles[i] << ": " << error << std::endl;
                 continue;
             }
 
-            std::cout << "Created Track in " << creationTime << std::endl;
-        }
+            // job files get moved around together with their data, so their paths are relative to the job file
+            const auto resolvePath = [&jobPath](const std::string &path) {
+                return std::filesystem::path(path).is_relative() ? (jobPath.parent_path() / path).string() : path;
+            };
+            for (auto &rasterFile: data->rasterFiles) {
+                rasterFile = resolvePath(rasterFile);
+            }
+            if (!data->outputPath.empty()) {
+                data->outputPath = resolvePath(data->outputPath);
+                std::error_code ec;
+                std::filesystem::create_directories(data->outputPath, ec); // gets validated by the job
+            }
+            if (data->name.empty()) {
+                data->name = jobPath.stem().string();
+            }
 
-        std::cout << "Finished Track!" << std::endl;
+            if (jobQueue.Enqueue(data) >= 0) {
+                jobs[i] = data;
+            }
+        }
 
+        jobQueue.WaitUntilIdle();
 
-        // waits for user input before closing console app
-        std::cout << "Press ENTER to close process" << std::endl;
-        std::cin.ignore();
-        std::string await;
-        std::getline(std::cin, await);
-        std::cout << await; // so variable does not get removed by optimizer
-
+        int failedJobs = 0;
+        std::cout << "Batch finished:" << std::endl;
+        for (int i = 0; i < jobFiles.size(); ++i) {
+            const bool finished = jobs[i] && jobs[i]->IsFinished();
+            std::cout << (finished ? " > done:   " : " > failed: ") << jobFiles[i];
+            if (jobs[i] && !finished) {
+                std::cout << " - " << jobs[i]->GetError();
+            }
+            std::cout << std::endl;
+            failedJobs += finished ? 0 : 1;
+        }
+        return failedJobs == 0 ? 0 : 1;
     } catch (const std::exception &e) {
         std::cout << e.what() << std::endl;
     } catch (...) {
         std::cout << "An unknown error happend :(" << std::endl;
     }
+    return 1;
+}
+
+void RunTrackJob(TrackData &data) {
+    std::cout << "Received data.. Creating Track \"" << data.name << "\".." << std::endl;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    data.SetProgress("Calculating paths between waypoints");
+    if (!pApp->ResolvePaths(data)) {
+        if (!CheckCancelled(data)) {
+            std::cout << data.GetError() << std::endl;
+        }
+        return;
+    }
+
+    // the coarsest preview only takes a moment, so the user sees the track long before the real build finished
+    RenderPreview(data, 0);
+
+    if (!CreateTrack(data))
+        return;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto creationTime = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    std::cout << "Created Track \"" << data.name << "\" in " << creationTime << std::endl;
+}
+
+/// @return true if track creation got cancelled, sets the error on the data in that case
+bool CheckCancelled(TrackData &data) {
+    if (!data.IsCancelled())
+        return false;
+
+    std::cout << ERROR_CANCELLED << std::endl;
+    data.SetError(ERROR_CANCELLED);
+    return true;
 }
 
 bool CreateTrack(TrackData &data) {
@@ -164,15 +280,26 @@ bool CreateTrack(TrackData &data) {
     for (int i = 0; i < data.rasterFiles.size(); ++i) {
         const auto progress = std::format("[Task 1/4] Creating Terrain: Tile {}/{}", i + 1, data.rasterFiles.size());
         std::cout << progress << std::endl;
-        data.SetProgress(progress);
-        creator.AddRaster(data.rasterFiles[i]);
+        data.SetProgress(progress, 1, 4, static_cast<double>(i) / data.rasterFiles.size());
+        if (CheckCancelled(data))
+            return false;
+        creator.AddRaster(data.rasterFiles[i], MAX_TERRAIN_POINTS);
+
+        // finer previews follow the terrain creation, reading the rasters again is fast since they are cached by now
+        if (i + 1 == (data.rasterFiles.size() + 1) / 2) {
+            RenderPreview(data, 1);
+        }
     }
+    // last chance for a preview, adding the roads reprojects the paths in place
+    RenderPreview(data, 2);
 
     // creating roads
     for (int i = 0; i < data.paths.size(); ++i) {
         const auto progress = std::format("[Task 2/4] Creating Roads: Path {}/{}", i + 1, data.paths.size());
         std::cout << progress << std::endl;
-        data.SetProgress(progress);
+        data.SetProgress(progress, 2, 4, static_cast<double>(i) / data.paths.size());
+        if (CheckCancelled(data))
+            return false;
         // TODO: make width configurable
         creator.AddRoad(data.paths[i], data.projRef, 6);
     }
@@ -183,7 +310,7 @@ bool CreateTrack(TrackData &data) {
 
         const auto progress = "[Task 3/4] Setting spawn points";
         std::cout << progress << std::endl;
-        data.SetProgress(progress);
+        data.SetProgress(progress, 3, 4, 0);
 
         const auto path = data.paths[0];
         // Note: path[0] will not be added to path using CatmullRom interpolation so path[1] is the edge of the road
@@ -195,7 +322,9 @@ bool CreateTrack(TrackData &data) {
     {
         const auto progress = "[Task 4/4] Writing track to disk";
         std::cout << progress << std::endl;
-        data.SetProgress(progress);
+        data.SetProgress(progress, 4, 4, 0);
+        if (CheckCancelled(data))
+            return false;
 
         creator.Export(data.outputPath);
 
@@ -205,6 +334,19 @@ bool CreateTrack(TrackData &data) {
     return true;
 }
 
+/// Renders the preview mesh of the given level, failures only get logged since the track does not need the preview
+void RenderPreview(TrackData &data, const int level) {
+    if (data.IsCancelled())
+        return;
+
+    auto glb = TrackMapper::Web::render_track_preview(data, TrackMapper::Web::PREVIEW_GRID_SIZES[level]);
+    if (glb.empty()) {
+        std::cout << "Could not render preview of track \"" << data.name << "\"" << std::endl;
+        return;
+    }
+    data.SetPreview(level, std::move(glb));
+}
+
 void OpenWebpage(const std::string &url) {
     // following https://stackoverflow.com/questions/17347950/how-do-i-open-a-url-from-c and
     // https://stackoverflow.com/questions/5919996/how-to-detect-reliably-mac-os-x-ios-linux-windows-in-c-preprocessor
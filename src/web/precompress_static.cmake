@@ -0,0 +1,15 @@
+# gzips the text based static web files next to the originals, so the web app can serve them compressed without
+# compressing them on every request
+# usage: cmake -DSTATIC_DIR=<path to static folder> -P precompress_static.cmake
+
+file(GLOB_RECURSE STATIC_FILES
+        "${STATIC_DIR}/*.html"
+        "${STATIC_DIR}/*.js"
+        "${STATIC_DIR}/*.css"
+        "${STATIC_DIR}/*.svg"
+        "${STATIC_DIR}/*.json"
+)
+
+foreach (STATIC_FILE IN LISTS STATIC_FILES)
+    file(ARCHIVE_CREATE OUTPUT "${STATIC_FILE}.gz" PATHS "${STATIC_FILE}" FORMAT raw COMPRESSION GZip)
+endforeach ()
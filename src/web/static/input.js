@@ -37,8 +37,10 @@ const progressSpinner = document.getElementById('progress-spinner');
 const progressPopup = document.getElementById('progress-popup');
 progressPopup.classList.add('hide');
 
-const PROGRESS_UPDATE_INTERVAL_MS = 2000;
+const PROGRESS_UPDATE_INTERVAL_MS = 2000; // only used when progress can not be streamed
 let progressUpdaterId;
+let progressSocket;
+let trackJobId; // id of the track job currently shown in the progress popup
 
 // -- Adding Paths Functionality --
 map.on("click", onMapClick);
@@ -138,35 +140,51 @@ async function finishAddingPath() {
     });
 
     pathEntryList.appendChild(pathEntry);
+
+    showPathProfile(pathIndex);
+}
+
+// adds the total ascent and descent of the path to its entry, if any raster covers it
+async function showPathProfile(pathIndex) {
+    const rasterFilePaths = Object.keys(rasters).map(r => rasters[r].filePath);
+    if (rasterFilePaths.length === 0)
+        return;
+
+    const profile = await getElevationProfile(paths[pathIndex].positions, rasterFilePaths,
+        rasterCustomProjRef.value.trim());
+    const pathEntry = document.getElementById("path-" + pathIndex);
+    if (profile === undefined || profile["minHeight"] === undefined || pathEntry === null)
+        return;
+
+    pathEntry.querySelector("p").innerText += " (\u2191" + Math.round(profile["ascent"]) + "m \u2193" +
+        Math.round(profile["descent"]) + "m)";
 }
 
 async function addSegment(click) {
     const latLng = clampPosition(click.latlng);
 
-    const nodeId = await getClosestNodeToPosition(latLng.lat, latLng.lng);
+    const previousNodeId = curPath.positions.at(-1);
+    const { nodeId, location: nodeLocation, segment, error } =
+        await snapAndRoute(latLng.lat, latLng.lng, previousNodeId);
     console.log("Node ID: " + nodeId);
 
+    if (error) {
+        console.error(error);
+        alert("Error while trying to add waypoint:\n" + error);
+        return;
+    }
+
     if (nodeId === -1) {
         alert("No nearby node found in clicked area");
         return;
     }
 
-    const nodeLocation = await getNodeLocation(nodeId);
     console.log("Location: ", nodeLocation);
 
-    curPath.positions.push(nodeId);
-    const marker = L.marker(nodeLocation);
-    map.addLayer(marker);
-    curPath.markers.push(marker);
-
-    if (curPath.positions.length > 1) {
-        const segment = await getShortestPath(curPath.positions.at(-2), curPath.positions.at(-1));
+    if (segment !== undefined) {
         console.log("Segment: ", segment);
 
         if (segment.length === 0) {
-            curPath.positions.pop();
-            const marker = curPath.markers.pop();
-            map.removeLayer(marker);
             alert("No path fround to last position");
             return;
         }
@@ -175,6 +193,11 @@ async function addSegment(click) {
         map.addLayer(poly);
         curPath.segments.push(poly);
     }
+
+    curPath.positions.push(nodeId);
+    const marker = L.marker(nodeLocation);
+    map.addLayer(marker);
+    curPath.markers.push(marker);
 }
 
 // -- Adding Rasters Functionality --
@@ -192,7 +215,7 @@ function closeRasterPopup() {
 async function addRaster() {
     closeRasterPopup();
 
-    // replace '\' with '/' for base64 encoding
+    // normalize windows path separators
     const filePath = rasterPopupFilepath.value.replaceAll('\\', '/');
     const req = {
         filePath: filePath
@@ -215,13 +238,19 @@ async function addRaster() {
     if (Object.keys(rasters).length <= 0)
         rasterEntryPlaceholder.style.display = "none";
 
-    const poly = L.polyline([extend[0], extend[1], extend[3], extend[2], extend[0]], { color: "green" });
+    const corners = extend.corners;
+    const poly = L.polyline([corners[0], corners[1], corners[3], corners[2], corners[0]], { color: "green" });
     map.addLayer(poly);
 
+    // shows the terrain of the raster
+    const hillshade = createHillshadeLayer(extend.rasterId);
+    map.addLayer(hillshade);
+
     // creates new raster object
     const newRaster = {
         filePath: filePath,
-        polyline: poly
+        polyline: poly,
+        hillshade: hillshade
     };
 
     // add raster to the rasters dictionary using the strictly increasing rasterCounter as key
@@ -239,6 +268,7 @@ async function addRaster() {
     deleteBtn.addEventListener("click", () => {
         const raster = rasters[rasterIndex];
         map.removeLayer(raster.polyline);
+        map.removeLayer(raster.hillshade);
         document.getElementById("raster-" + rasterIndex).remove();
 
         delete rasters[rasterIndex];
@@ -254,7 +284,9 @@ async function addRaster() {
 async function startTrackCreation(){
     // show progress popup
     progressText.innerText = "Submitting Track Data";
+    progressSpinner.classList.remove('hide');
     progressPopup.classList.remove('hide');
+    resetPreview();
 
     // create track object
     let name = trackName.value.trim();
@@ -285,30 +317,87 @@ async function startTrackCreation(){
     const reqJson = JSON.stringify(track);
     console.log("Sending create track payload:", reqJson);
     console.log(track);
-    const res = await fetch("/api/create_track/" + btoa(reqJson));
+    const res = await fetch("/api/create_track", {
+        method: "POST",
+        headers: { "Content-Type": "application/json" },
+        body: reqJson
+    });
 
     // check if data send is valid
     const json = await res.json();
     if (json["error"]) {
         console.error(json["error"]);
+        progressPopup.classList.add('hide');
         alert("Error while trying to create track:\n" + json["error"]);
         return;
     }
 
-    // start periodic progress checker
+    trackJobId = json["jobId"];
+    startProgressStream();
+}
+
+async function cancelTrackCreation() {
+    const res = await fetch("/api/cancel_track/" + trackJobId, { method: "POST" });
+    const json = await res.json();
+    if (json["error"])
+        console.error(json["error"]);
+}
+
+function startProgressStream() {
+    if (!("WebSocket" in window)) {
+        startProgressPolling();
+        return;
+    }
+
+    let receivedEvent = false;
+    progressSocket = new WebSocket("ws://" + window.location.host + "/api/progress_stream");
+    // the server only sends the events of jobs the socket subscribed to
+    progressSocket.onopen = () => progressSocket.send(String(trackJobId));
+    progressSocket.onmessage = (msg) => {
+        receivedEvent = true;
+        handleProgress(JSON.parse(msg.data));
+    };
+    progressSocket.onclose = () => {
+        // falls back to polling if the stream could not be opened or broke off before the track was finished
+        if (progressSocket !== undefined) {
+            progressSocket = undefined;
+            startProgressPolling();
+        }
+        if (!receivedEvent)
+            console.log("Progress stream unavailable, polling progress instead");
+    };
+}
+
+function stopProgressUpdates() {
+    clearInterval(progressUpdaterId);
+    if (progressSocket !== undefined) {
+        const socket = progressSocket;
+        progressSocket = undefined;
+        socket.close();
+    }
+}
+
+function startProgressPolling() {
     progressUpdaterId = setInterval(updateProgress, PROGRESS_UPDATE_INTERVAL_MS);
     updateProgress();
 }
 
 async function updateProgress(){
-    const res = await fetch("/api/get_progress");
-    const json = await res.json();
+    const res = await fetch("/api/get_progress/" + trackJobId);
+    handleProgress(await res.json());
+}
 
+function handleProgress(json) {
     progressText.innerText = json["progress"];
+    if (json["stageCount"] > 0) {
+        const percent = Math.round(100 * (json["stage"] - 1 + json["stageFraction"]) / json["stageCount"]);
+        progressText.innerText += " (" + percent + "%, " + Math.round(json["elapsed"]) + "s)";
+    }
+    updatePreview(trackJobId, json["previewLevel"]);
 
     if(json["finished"]){
         console.log("Track creation finished!");
-        clearInterval(progressUpdaterId);
+        stopProgressUpdates();
         progressText.innerText = "Track creation finished, tab can be closed now..";
         progressSpinner.classList.add('hide');
     }
@@ -316,10 +405,9 @@ async function updateProgress(){
     if (json["error"]) {
         console.log("Track creation failed!");
         console.error(json["error"]);
-        alert("Error while trying to create track:\n" + json["error"]);
-
-        clearInterval(progressUpdaterId);
+        stopProgressUpdates();
         progressPopup.classList.add('hide');
+        alert("Error while trying to create track:\n" + json["error"]);
         return;
     }
 }
@@ -9,35 +9,83 @@ L.tileLayer('https://tile.openstreetmap.org/{z}/{x}/{y}.png', {
     attribution: '&copy; <a href="http://www.openstreetmap.org/copyright">OpenStreetMap</a>'
 }).addTo(map);
 
-async function getClosestNodeToPosition(latitude, longitude) {
-    const res = await fetch("/api/get_node/" + latitude + "/" + longitude);
-    const json = await res.json();
-    return json["nodeId"];
-}
+// edges of the routing graph, the server only provides them from zoom level 10 on
+const roadLayer = L.vectorGrid.protobuf("/api/tiles/roads/{z}/{x}/{y}.pbf", {
+    minZoom: 10,
+    maxZoom: 19,
+    vectorTileLayerStyles: {
+        roads: { weight: 2, color: "#3388ff", opacity: 0.7 }
+    }
+}).addTo(map);
+L.control.layers(null, { "Routable roads": roadLayer }).addTo(map);
+
+// snaps the position to the closest node and gets the path from the previous node to it in a single request
+async function snapAndRoute(latitude, longitude, previousNodeId) {
+    let url = "/api/snap_route/" + latitude + "/" + longitude;
+    if (previousNodeId !== undefined)
+        url += "?from=" + previousNodeId;
 
-async function getNodeLocation(nodeId) {
-    const res = await fetch("/api/get_location/" + nodeId);
+    const res = await fetch(url);
     const json = await res.json();
-    return L.latLng(json["lat"], json["lon"]);
+    if (json["error"])
+        return { nodeId: -1, error: json["error"] };
+
+    const result = { nodeId: json["nodeId"] };
+    if (result.nodeId === -1)
+        return result;
+
+    result.location = L.latLng(json["lat"], json["lon"]);
+    if (json["polyline"] !== undefined)
+        result.segment = json["distance"] === -1 ? [] : decodePolyline(json["polyline"], json["precision"]);
+    return result;
 }
 
 async function getShortestPath(startNodeId, targetNodeId) {
-    const res = await fetch("/api/get_path/" + startNodeId + "/" + targetNodeId);
+    const res = await fetch("/api/get_path/" + startNodeId + "/" + targetNodeId + "?format=polyline");
     const json = await res.json();
-    const path = [];
 
     if (json["distance"] === -1)
-        return path; // no path found
+        return []; // no path found
 
-    json["nodes"].forEach((node) => {
-        path.push(L.latLng(node["lat"], node["lon"]));
-    });
+    return decodePolyline(json["polyline"], json["precision"]);
+}
+
+// decodes a delta coded polyline, see https://developers.google.com/maps/documentation/utilities/polylinealgorithm
+function decodePolyline(encoded, precision) {
+    const factor = Math.pow(10, precision);
+    const path = [];
+
+    let index = 0;
+    let lat = 0;
+    let lng = 0;
+    const readValue = () => {
+        let result = 0;
+        let shift = 1; // multiplication instead of bit shifts, so values above 32 bits stay exact
+        let byte;
+        do {
+            byte = encoded.charCodeAt(index++) - 63;
+            result += (byte & 0x1f) * shift;
+            shift *= 32;
+        } while (byte >= 0x20);
+        // undo zigzag encoding
+        return result % 2 === 1 ? -(result + 1) / 2 : result / 2;
+    };
+
+    while (index < encoded.length) {
+        lat += readValue();
+        lng += readValue();
+        path.push(L.latLng(lat / factor, lng / factor));
+    }
 
     return path;
 }
 
 async function getRasterExtend(reqJson) {
-    const res = await fetch("/api/get_raster_extend/" + btoa(reqJson));
+    const res = await fetch("/api/get_raster_extend", {
+        method: "POST",
+        headers: { "Content-Type": "application/json" },
+        body: reqJson
+    });
     const json = await res.json();
     const rect = [];
 
@@ -50,7 +98,38 @@ async function getRasterExtend(reqJson) {
         rect.push(L.latLng(node["lat"], node["lon"]));
     });
 
-    return rect;
+    return { corners: rect, rasterId: json["rasterId"] };
+}
+
+// gets the heights along the path through the waypoints, sampled from the rasters
+async function getElevationProfile(nodeIds, rasterFilePaths, projRef) {
+    const res = await fetch("/api/get_elevation_profile", {
+        method: "POST",
+        headers: { "Content-Type": "application/json" },
+        body: JSON.stringify({ path: nodeIds, rasters: rasterFilePaths, wkt: projRef })
+    });
+    const json = await res.json();
+
+    if (json["error"] != undefined) {
+        console.error(json["error"])
+        return undefined;
+    }
+
+    // heights are sent in decimeters, samples not covered by any raster are null
+    json["heights"] = json["heights"].map(h => h === null ? null : h / 10);
+    return json;
+}
+
+// transparent 1x1 gif, shown for tiles that do not overlap the raster
+const EMPTY_TILE = "data:image/gif;base64,R0lGODlhAQABAIAAAAAAAP///yH5BAEAAAAALAAAAAABAAEAAAIBRAA7";
+
+function createHillshadeLayer(rasterId) {
+    return L.tileLayer("/api/tiles/hillshade/{z}/{x}/{y}.png?raster=" + rasterId, {
+        maxZoom: 19,
+        minZoom: 2,
+        opacity: 0.6,
+        errorTileUrl: EMPTY_TILE
+    });
 }
 
 function clampPosition(latLng) {
@@ -0,0 +1,268 @@
+// -- Track Preview Variables --
+const previewCanvas = document.getElementById('preview-canvas');
+previewCanvas.classList.add('hide');
+
+const PREVIEW_VERTEX_SHADER = `#version 300 es
+in vec3 position;
+in vec3 normal;
+uniform mat4 viewProjection;
+out vec3 vNormal;
+void main() {
+    vNormal = normal;
+    gl_Position = viewProjection * vec4(position, 1.0);
+}`;
+const PREVIEW_FRAGMENT_SHADER = `#version 300 es
+precision mediump float;
+in vec3 vNormal;
+uniform vec4 color;
+uniform vec3 lightDirection;
+out vec4 fragColor;
+void main() {
+    float light = 0.35 + 0.65 * max(dot(normalize(vNormal), lightDirection), 0.0);
+    fragColor = vec4(pow(color.rgb * light, vec3(1.0 / 2.2)), color.a); // colors of gltf are linear
+}`;
+
+let previewGl; // undefined if the browser does not support webgl2
+let previewProgram;
+let previewMeshes = []; // uploaded meshes of the shown preview
+let previewLevel = -1; // level of the shown preview, finer levels replace coarser ones
+let previewCamera = { yaw: 0.6, pitch: 0.7, distance: 1, target: [0, 0, 0] };
+let previewDrag; // last pointer position while the view gets rotated
+
+initPreview();
+
+function initPreview() {
+    previewGl = previewCanvas.getContext('webgl2');
+    if (!previewGl) {
+        console.log("WebGL2 unavailable, track preview disabled");
+        return;
+    }
+
+    const gl = previewGl;
+    const compile = (type, source) => {
+        const shader = gl.createShader(type);
+        gl.shaderSource(shader, source);
+        gl.compileShader(shader);
+        if (!gl.getShaderParameter(shader, gl.COMPILE_STATUS))
+            console.error(gl.getShaderInfoLog(shader));
+        return shader;
+    };
+    previewProgram = gl.createProgram();
+    gl.attachShader(previewProgram, compile(gl.VERTEX_SHADER, PREVIEW_VERTEX_SHADER));
+    gl.attachShader(previewProgram, compile(gl.FRAGMENT_SHADER, PREVIEW_FRAGMENT_SHADER));
+    gl.linkProgram(previewProgram);
+
+    // drag rotates around the track, the wheel zooms
+    previewCanvas.addEventListener('pointerdown', e => {
+        previewDrag = [e.clientX, e.clientY];
+        previewCanvas.setPointerCapture(e.pointerId);
+    });
+    previewCanvas.addEventListener('pointerup', () => previewDrag = undefined);
+    previewCanvas.addEventListener('pointermove', e => {
+        if (previewDrag === undefined)
+            return;
+        previewCamera.yaw -= (e.clientX - previewDrag[0]) * 0.01;
+        previewCamera.pitch = Math.min(1.5, Math.max(0.05, previewCamera.pitch + (e.clientY - previewDrag[1]) * 0.01));
+        previewDrag = [e.clientX, e.clientY];
+        drawPreview();
+    });
+    previewCanvas.addEventListener('wheel', e => {
+        e.preventDefault();
+        previewCamera.distance *= Math.exp(e.deltaY * 0.001);
+        drawPreview();
+    });
+}
+
+// hides the preview of the previous track, called when a new track gets submitted
+function resetPreview() {
+    previewLevel = -1;
+    previewCanvas.classList.add('hide');
+}
+
+// loads the preview of the job if the server announced a finer level than the shown one
+async function updatePreview(jobId, level) {
+    if (!previewGl || level === undefined || level <= previewLevel)
+        return;
+    previewLevel = level;
+
+    const res = await fetch("/api/get_preview/" + jobId);
+    if (res.status !== 200)
+        return; // 204 if the job has no preview yet
+
+    let meshes;
+    try {
+        meshes = parseGlb(await res.arrayBuffer());
+    } catch (e) {
+        console.error("Could not read track preview:", e);
+        return;
+    }
+
+    const firstPreview = previewMeshes.length === 0;
+    uploadPreviewMeshes(meshes);
+    if (firstPreview) {
+        // frames the whole preview, finer levels cover the same area so the view is kept for them
+        const min = [Infinity, Infinity, Infinity], max = [-Infinity, -Infinity, -Infinity];
+        for (const mesh of meshes) {
+            for (let i = 0; i < 3; i++) {
+                min[i] = Math.min(min[i], mesh.min[i]);
+                max[i] = Math.max(max[i], mesh.max[i]);
+            }
+        }
+        previewCamera.target = [0, 1, 2].map(i => (min[i] + max[i]) / 2);
+        previewCamera.distance = Math.max(max[0] - min[0], max[2] - min[2]) * 0.9;
+    }
+
+    previewCanvas.classList.remove('hide');
+    drawPreview();
+}
+
+// reads the meshes of the binary gltf files written by the server, a single primitive with positions, normals and
+// uint32 indices per mesh and a base color per material
+function parseGlb(buffer) {
+    const view = new DataView(buffer);
+    if (view.getUint32(0, true) !== 0x46546C67)
+        throw new Error("not a binary gltf file");
+
+    const jsonLength = view.getUint32(12, true);
+    const gltf = JSON.parse(new TextDecoder().decode(new Uint8Array(buffer, 20, jsonLength)));
+    const binOffset = 20 + jsonLength + 8;
+
+    const readAccessor = (index, ArrayType, components) => {
+        const accessor = gltf.accessors[index];
+        const bufferView = gltf.bufferViews[accessor.bufferView];
+        const offset = binOffset + (bufferView.byteOffset ?? 0) + (accessor.byteOffset ?? 0);
+        return new ArrayType(buffer, offset, accessor.count * components);
+    };
+
+    return gltf.meshes.map(mesh => {
+        const primitive = mesh.primitives[0];
+        const material = gltf.materials[primitive.material];
+        const positionAccessor = gltf.accessors[primitive.attributes.POSITION];
+        return {
+            positions: readAccessor(primitive.attributes.POSITION, Float32Array, 3),
+            normals: readAccessor(primitive.attributes.NORMAL, Float32Array, 3),
+            indices: readAccessor(primitive.indices, Uint32Array, 1),
+            color: material.pbrMetallicRoughness.baseColorFactor,
+            isRoad: mesh.name === "roads",
+            min: positionAccessor.min,
+            max: positionAccessor.max
+        };
+    });
+}
+
+function uploadPreviewMeshes(meshes) {
+    const gl = previewGl;
+    for (const mesh of previewMeshes) {
+        gl.deleteVertexArray(mesh.vao);
+        mesh.buffers.forEach(b => gl.deleteBuffer(b));
+    }
+
+    previewMeshes = meshes.map(mesh => {
+        const vao = gl.createVertexArray();
+        gl.bindVertexArray(vao);
+        const createBuffer = (target, data) => {
+            const buffer = gl.createBuffer();
+            gl.bindBuffer(target, buffer);
+            gl.bufferData(target, data, gl.STATIC_DRAW);
+            return buffer;
+        };
+        const buffers = [];
+        for (const [name, data] of [["position", mesh.positions], ["normal", mesh.normals]]) {
+            buffers.push(createBuffer(gl.ARRAY_BUFFER, data));
+            const location = gl.getAttribLocation(previewProgram, name);
+            gl.enableVertexAttribArray(location);
+            gl.vertexAttribPointer(location, 3, gl.FLOAT, false, 0, 0);
+        }
+        buffers.push(createBuffer(gl.ELEMENT_ARRAY_BUFFER, mesh.indices));
+        gl.bindVertexArray(null);
+
+        return { vao: vao, buffers: buffers, count: mesh.indices.length, color: mesh.color, isRoad: mesh.isRoad };
+    });
+}
+
+function drawPreview() {
+    const gl = previewGl;
+    const width = Math.round(previewCanvas.clientWidth * window.devicePixelRatio);
+    const height = Math.round(previewCanvas.clientHeight * window.devicePixelRatio);
+    if (previewCanvas.width !== width || previewCanvas.height !== height) {
+        previewCanvas.width = width;
+        previewCanvas.height = height;
+    }
+    gl.viewport(0, 0, width, height);
+    gl.clearColor(0.85, 0.9, 0.95, 1);
+    gl.clear(gl.COLOR_BUFFER_BIT | gl.DEPTH_BUFFER_BIT);
+    gl.enable(gl.DEPTH_TEST);
+    gl.enable(gl.CULL_FACE);
+
+    const { yaw, pitch, distance, target } = previewCamera;
+    const eye = [
+        target[0] + distance * Math.cos(pitch) * Math.sin(yaw),
+        target[1] + distance * Math.sin(pitch),
+        target[2] + distance * Math.cos(pitch) * Math.cos(yaw)
+    ];
+    const projection = perspectiveMatrix(Math.PI / 4, width / Math.max(1, height), distance / 100, distance * 10);
+    const viewProjection = multiplyMatrices(projection, lookAtMatrix(eye, target));
+
+    gl.useProgram(previewProgram);
+    gl.uniformMatrix4fv(gl.getUniformLocation(previewProgram, "viewProjection"), false, viewProjection);
+    gl.uniform3fv(gl.getUniformLocation(previewProgram, "lightDirection"), normalizeVector([0.4, 0.8, 0.3]));
+    const colorLocation = gl.getUniformLocation(previewProgram, "color");
+    for (const mesh of previewMeshes) {
+        // roads lie directly on the terrain and get pulled in front of it
+        if (mesh.isRoad) {
+            gl.enable(gl.POLYGON_OFFSET_FILL);
+            gl.polygonOffset(-1, -4);
+        }
+        gl.uniform4fv(colorLocation, mesh.color);
+        gl.bindVertexArray(mesh.vao);
+        gl.drawElements(gl.TRIANGLES, mesh.count, gl.UNSIGNED_INT, 0);
+        gl.disable(gl.POLYGON_OFFSET_FILL);
+    }
+    gl.bindVertexArray(null);
+}
+
+// -- Matrix Helpers (column major like webgl expects them) --
+function perspectiveMatrix(fovY, aspect, near, far) {
+    const f = 1 / Math.tan(fovY / 2);
+    return new Float32Array([
+        f / aspect, 0, 0, 0,
+        0, f, 0, 0,
+        0, 0, (far + near) / (near - far), -1,
+        0, 0, 2 * far * near / (near - far), 0
+    ]);
+}
+
+function lookAtMatrix(eye, target) {
+    const z = normalizeVector([eye[0] - target[0], eye[1] - target[1], eye[2] - target[2]]);
+    const x = normalizeVector(crossVectors([0, 1, 0], z));
+    const y = crossVectors(z, x);
+    const dot = (a, b) => a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    return new Float32Array([
+        x[0], y[0], z[0], 0,
+        x[1], y[1], z[1], 0,
+        x[2], y[2], z[2], 0,
+        -dot(x, eye), -dot(y, eye), -dot(z, eye), 1
+    ]);
+}
+
+function multiplyMatrices(a, b) {
+    const result = new Float32Array(16);
+    for (let column = 0; column < 4; column++) {
+        for (let row = 0; row < 4; row++) {
+            let sum = 0;
+            for (let k = 0; k < 4; k++)
+                sum += a[k * 4 + row] * b[column * 4 + k];
+            result[column * 4 + row] = sum;
+        }
+    }
+    return result;
+}
+
+function crossVectors(a, b) {
+    return [a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]];
+}
+
+function normalizeVector(v) {
+    const length = Math.hypot(v[0], v[1], v[2]);
+    return [v[0] / length, v[1] / length, v[2] / length];
+}